@@ -8,8 +8,636 @@
 // Dyson Sphere Program is developed by Youthcat Studio and published by Gamera Game.
 
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <numeric>
+#include <thread>
 #include "DysonSphereParser.h"
+#include "DysonSphereSchema.h"
+#include "DysonSphereSnapshot.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// SSE2 is part of every x64 target, and of x86 builds which enable it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DSP_SSE2 1
+#include <emmintrin.h>
+#else
+#define DSP_SSE2 0
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+DysonSphereParser::Projection::Projection(const bool selected) :
+	planet(selected),
+	entities(selected),
+	prebuilds(selected),
+	vegetation(selected),
+	veins(selected),
+	cargoContainer(selected),
+	cargoTraffic(selected),
+	factoryStorage(selected),
+	powerSystem(selected),
+	factorySystem(selected),
+	transport(selected),
+	monsterSystem(selected),
+	platformSystem(selected),
+	statistics(selected),
+	mainPlayer(selected),
+	factories(selected),
+	dysonSpheres(selected)
+{
+}
+
+bool DysonSphereParser::Projection::isFull() const
+{
+	return planet && entities && prebuilds && vegetation && veins && cargoContainer && cargoTraffic && factoryStorage
+		&& powerSystem && factorySystem && transport && monsterSystem && platformSystem
+		&& statistics && mainPlayer && factories && dysonSpheres;
+}
+
+DysonSphereParser::ParseOptions::ParseOptions() :
+	inputMode(EInputMode::Stream),
+	parallelFactories(false),
+	threadCount(0),
+	lazyFactories(false),
+	streamChunkSize(256 * 1024),
+	useSectionIndex(false),
+	buildEntityTable(false),
+	buildEntityIndex(false),
+	useArena(false),
+	errorMode(EErrorMode::Throw),
+	useSnapshot(false),
+	visitor(nullptr)
+{
+}
+
+DysonSphereParser::ParseFailure::ParseFailure() :
+	className(nullptr),
+	field(nullptr),
+	offset(-1)
+{
+}
+
+std::string DysonSphereParser::ParseFailure::describe() const
+{
+	if (offset < 0)
+		return std::string();
+	if (className == nullptr)
+		return "Unexpected end of file at offset " + std::to_string(offset);
+	return std::string("Unexpected ") + className + " " + field + " at offset " + std::to_string(offset);
+}
+
+DysonSphereParser::InputStream::InputStream() :
+	m_mode(EInputMode::Stream),
+	m_nextSize(0),
+	m_nextPending(false),
+	m_stopReader(false),
+	m_begin(nullptr),
+	m_cursor(nullptr),
+	m_end(nullptr),
+	m_chunkOffset(0),
+	m_length(0),
+	m_failed(true),
+	m_sectionIndex(nullptr),
+	m_mappedView(nullptr),
+#ifdef _WIN32
+	m_fileHandle(nullptr),
+	m_mappingHandle(nullptr)
+#else
+	m_fileDescriptor(-1)
+#endif
+{
+}
+
+DysonSphereParser::InputStream::~InputStream()
+{
+	close();
+}
+
+bool DysonSphereParser::InputStream::open(const char* const filename, const EInputMode mode)
+{
+	close();
+	if (mode == EInputMode::MemoryMapped)
+	{
+#ifdef _WIN32
+		HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		m_fileHandle = file == INVALID_HANDLE_VALUE ? nullptr : file;
+#else
+		m_fileDescriptor = ::open(filename, O_RDONLY);
+#endif
+		if (openMapping())
+			return true;
+	}
+
+	m_file.open(filename, std::ios_base::binary);
+	return openStream(mode);
+}
+
+bool DysonSphereParser::InputStream::open(const wchar_t* const filename, const EInputMode mode)
+{
+#ifdef _WIN32
+	close();
+	if (mode == EInputMode::MemoryMapped)
+	{
+		HANDLE file = CreateFileW(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		m_fileHandle = file == INVALID_HANDLE_VALUE ? nullptr : file;
+		if (openMapping())
+			return true;
+	}
+
+	m_file.open(filename, std::ios_base::binary);
+	return openStream(mode);
+#else
+	std::string narrow(wcslen(filename) * MB_CUR_MAX + 1, '\0');
+	const size_t length = wcstombs(&narrow[0], filename, narrow.size());
+	if (length == static_cast<size_t>(-1))
+		return false;
+	narrow.resize(length);
+	return open(narrow.c_str(), mode);
+#endif
+}
+
+// Sets up chunked reading of the file which open() has just opened.  ReadAhead starts the reader
+// on the first chunk right away.
+bool DysonSphereParser::InputStream::openStream(const EInputMode mode)
+{
+	if (!m_file)
+		return false;
+	m_file.seekg(0, std::ios_base::end);
+	m_length = m_file.tellg();
+	m_file.seekg(0, std::ios_base::beg);
+	m_chunk.resize(static_cast<size_t>(std::max(m_options.streamChunkSize, 64)));
+	m_mode = mode == EInputMode::ReadAhead ? EInputMode::ReadAhead : EInputMode::Stream;
+	m_failed = false;
+	if (m_mode == EInputMode::ReadAhead)
+	{
+		m_nextChunk.resize(m_chunk.size());
+		m_nextPending = true;
+		m_reader = std::thread(&InputStream::readAhead, this);
+	}
+	fill();
+	return true;
+}
+
+// Maps the file which open() has just opened.  On failure the file is released so that open()
+// can fall back to Stream mode, e.g. for 32-bit builds which cannot map a large save.
+bool DysonSphereParser::InputStream::openMapping()
+{
+#ifdef _WIN32
+	LARGE_INTEGER size;
+	if (m_fileHandle != nullptr && GetFileSizeEx(m_fileHandle, &size) && size.QuadPart > 0)
+	{
+		m_length = size.QuadPart;
+		m_mappingHandle = CreateFileMappingW(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_mappingHandle != nullptr)
+			m_mappedView = MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	}
+#else
+	struct stat status;
+	if (m_fileDescriptor >= 0 && fstat(m_fileDescriptor, &status) == 0 && status.st_size > 0)
+	{
+		m_length = status.st_size;
+		void* view = mmap(nullptr, static_cast<size_t>(m_length), PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+		if (view != MAP_FAILED)
+		{
+			madvise(view, static_cast<size_t>(m_length), MADV_SEQUENTIAL);
+			m_mappedView = view;
+		}
+	}
+#endif
+
+	if (m_mappedView == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	m_mode = EInputMode::MemoryMapped;
+	m_begin = static_cast<const char*>(m_mappedView);
+	m_cursor = m_begin;
+	m_end = m_begin + m_length;
+	m_chunkOffset = 0;
+	m_failed = false;
+	return true;
+}
+
+// Starts an independent cursor at position over the view of a MemoryMapped source.  The source
+// keeps ownership of the mapping and has to stay open while this cursor is used.
+void DysonSphereParser::InputStream::attach(const InputStream& source, const int64_t position)
+{
+	assert(source.m_mode == EInputMode::MemoryMapped);
+	close();
+	m_mode = EInputMode::MemoryMapped;
+	m_options = source.m_options;
+	m_sectionIndex = source.m_sectionIndex;
+	m_begin = source.m_begin;
+	m_cursor = m_begin;
+	m_end = source.m_end;
+	m_length = source.m_length;
+	m_failed = source.m_mode != EInputMode::MemoryMapped;
+	seekg(position);
+}
+
+void DysonSphereParser::InputStream::close()
+{
+	if (m_reader.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_readerMutex);
+			m_stopReader = true;
+		}
+		m_readerSignal.notify_all();
+		m_reader.join();
+		m_stopReader = false;
+		m_nextPending = false;
+	}
+	m_nextChunk.clear();
+
+#ifdef _WIN32
+	if (m_mappedView != nullptr)
+		UnmapViewOfFile(m_mappedView);
+	if (m_mappingHandle != nullptr)
+		CloseHandle(m_mappingHandle);
+	if (m_fileHandle != nullptr)
+		CloseHandle(m_fileHandle);
+	m_mappingHandle = nullptr;
+	m_fileHandle = nullptr;
+#else
+	if (m_mappedView != nullptr)
+		munmap(m_mappedView, static_cast<size_t>(m_length));
+	if (m_fileDescriptor >= 0)
+		::close(m_fileDescriptor);
+	m_fileDescriptor = -1;
+#endif
+	m_mappedView = nullptr;
+
+	if (m_file.is_open())
+		m_file.close();
+	m_file.clear();
+	m_chunk.clear();
+	m_mode = EInputMode::Stream;
+	m_begin = nullptr;
+	m_cursor = nullptr;
+	m_end = nullptr;
+	m_chunkOffset = 0;
+	m_length = 0;
+	m_failed = true;
+	m_failure = ParseFailure();
+}
+
+void DysonSphereParser::InputStream::seekg(const int64_t position)
+{
+	if (m_failed)
+		return;
+	if (position < 0 || position > m_length)
+	{
+		stop();
+		return;
+	}
+
+	if (position >= m_chunkOffset && position <= m_chunkOffset + (m_end - m_begin))
+	{
+		m_cursor = m_begin + (position - m_chunkOffset);
+		return;
+	}
+
+	if (m_mode == EInputMode::ReadAhead)
+	{
+		// A forward skip which lands in the chunk read ahead keeps it, anything else restarts the
+		// reader at position.
+		const int64_t nextOffset = m_chunkOffset + (m_end - m_begin);
+		{
+			std::unique_lock<std::mutex> lock(m_readerMutex);
+			m_readerSignal.wait(lock, [this]() { return !m_nextPending; });
+			if (position < nextOffset || position >= nextOffset + m_nextSize)
+			{
+				m_file.clear();
+				m_file.seekg(position, std::ios_base::beg);
+				m_nextPending = true;
+				m_chunkOffset = position;
+				m_begin = m_chunk.data();
+				m_end = m_begin;
+			}
+		}
+		m_readerSignal.notify_all();
+		fill();
+		m_cursor = m_begin + (position - m_chunkOffset);
+		return;
+	}
+
+	// Only Stream mode can get here, the mapped view covers the whole file.
+	m_file.clear();
+	m_file.seekg(position, std::ios_base::beg);
+	m_chunkOffset = position;
+	m_begin = m_chunk.data();
+	m_cursor = m_begin;
+	m_end = m_begin;
+	fill();
+}
+
+const char* DysonSphereParser::InputStream::view(const int64_t position, const int64_t count) const
+{
+	if (m_mode != EInputMode::MemoryMapped || m_failed || position < 0 || count < 0 || position + count > m_length)
+		return nullptr;
+	return m_begin + position;
+}
+
+void DysonSphereParser::InputStream::skipSlow(const int64_t count)
+{
+	if (count < 0)
+		stop();
+	else
+		seekg(tellg() + count);
+}
+
+void DysonSphereParser::InputStream::fill()
+{
+	m_chunkOffset += m_end - m_begin;
+	int64_t size = 0;
+	if (m_mode == EInputMode::ReadAhead)
+	{
+		// Takes the chunk the reader has finished and sends it on to the one after.
+		{
+			std::unique_lock<std::mutex> lock(m_readerMutex);
+			m_readerSignal.wait(lock, [this]() { return !m_nextPending; });
+			m_chunk.swap(m_nextChunk);
+			size = m_nextSize;
+			m_nextPending = true;
+		}
+		m_readerSignal.notify_all();
+	}
+	else
+	{
+		m_file.read(m_chunk.data(), m_chunk.size());
+		size = m_file.gcount();
+	}
+	m_begin = m_chunk.data();
+	m_cursor = m_begin;
+	m_end = m_begin + size;
+}
+
+// Body of the ReadAhead thread.  Reads the next chunk whenever fill() or seekg() asks for one.
+void DysonSphereParser::InputStream::readAhead()
+{
+	std::unique_lock<std::mutex> lock(m_readerMutex);
+	for (;;)
+	{
+		m_readerSignal.wait(lock, [this]() { return m_nextPending || m_stopReader; });
+		if (m_stopReader)
+			return;
+		lock.unlock();
+		m_file.read(m_nextChunk.data(), m_nextChunk.size());
+		const int64_t size = m_file.gcount();
+		lock.lock();
+		m_nextSize = size;
+		m_nextPending = false;
+		m_readerSignal.notify_all();
+	}
+}
+
+void DysonSphereParser::InputStream::readSlow(char* buffer, int64_t count)
+{
+	if (m_failed)
+	{
+		memset(buffer, 0, static_cast<size_t>(count));
+		return;
+	}
+
+	while (count > 0)
+	{
+		const int64_t available = m_end - m_cursor;
+		if (available >= count)
+		{
+			memcpy(buffer, m_cursor, static_cast<size_t>(count));
+			m_cursor += count;
+			return;
+		}
+
+		memcpy(buffer, m_cursor, static_cast<size_t>(available));
+		m_cursor += available;
+		buffer += available;
+		count -= available;
+
+		if (m_mode == EInputMode::MemoryMapped || (m_mode == EInputMode::Stream && !m_file))
+			break;
+		if (m_mode == EInputMode::Stream && count >= static_cast<int64_t>(m_chunk.size()))
+		{
+			// Large blocks, like the screenshot, bypass the chunk buffer.
+			m_file.read(buffer, count);
+			const int64_t copied = m_file.gcount();
+			m_chunkOffset += (m_end - m_begin) + copied;
+			m_begin = m_chunk.data();
+			m_cursor = m_begin;
+			m_end = m_begin;
+			buffer += copied;
+			count -= copied;
+		}
+		else
+		{
+			fill();
+			if (m_end == m_begin)
+				break;
+		}
+	}
+
+	if (count > 0)
+	{
+		memset(buffer, 0, static_cast<size_t>(count));
+		stop();
+	}
+}
+
+// Remembers where the stream stopped, unless an earlier failure already has, and moves the end up
+// to the cursor so that every later read takes the zero-filling slow path.
+void DysonSphereParser::InputStream::stop()
+{
+	if (!m_failed && !m_failure)
+		m_failure.offset = tellg();
+	m_failed = true;
+	m_end = m_cursor;
+}
+
+void DysonSphereParser::InputStream::fail(const char* const className, const char* const field)
+{
+	if (!m_failure)
+	{
+		m_failure.className = className;
+		m_failure.field = field;
+		m_failure.offset = m_failed ? m_length : tellg();
+	}
+	stop();
+	if (m_options.errorMode == EErrorMode::Throw)
+	{
+		assert(false);
+		throw std::exception(m_failure.describe().c_str());
+	}
+}
+
+// The chunk still matches the file up to the cursor, so the next seekg() carries on from there.
+void DysonSphereParser::InputStream::recover()
+{
+	m_failed = false;
+	m_failure = ParseFailure();
+}
+
+void DysonSphereParser::InputStream::fail(const ParseFailure& failure)
+{
+	if (!m_failure)
+		m_failure = failure;
+	stop();
+	if (m_options.errorMode == EErrorMode::Throw)
+	{
+		assert(false);
+		throw std::exception(m_failure.describe().c_str());
+	}
+}
+
+DysonSphereParser::OutputStream::OutputStream() :
+	m_chunk(chunkSize),
+	m_cursor(m_chunk.data()),
+	m_end(m_chunk.data() + m_chunk.size()),
+	m_chunkOffset(0),
+	m_failed(false)
+{
+}
+
+DysonSphereParser::OutputStream::~OutputStream()
+{
+	close();
+}
+
+bool DysonSphereParser::OutputStream::open(const std::filesystem::path& path)
+{
+	close();
+	m_file.clear();
+	m_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	m_cursor = m_chunk.data();
+	m_chunkOffset = 0;
+	m_failed = !m_file.is_open();
+	return !m_failed;
+}
+
+bool DysonSphereParser::OutputStream::close()
+{
+	flush();
+	if (m_file.is_open())
+	{
+		m_file.close();
+		if (!m_file)
+			m_failed = true;
+	}
+	return !m_failed;
+}
+
+// Without a file the chunk is just dropped, keeping only the count.
+void DysonSphereParser::OutputStream::flush()
+{
+	const int64_t size = m_cursor - m_chunk.data();
+	if (size > 0 && m_file.is_open() && !m_file.write(m_chunk.data(), size))
+		m_failed = true;
+	m_chunkOffset += size;
+	m_cursor = m_chunk.data();
+}
+
+void DysonSphereParser::OutputStream::writeSlow(const char* buffer, int64_t count)
+{
+	flush();
+	if (count >= static_cast<int64_t>(m_chunk.size()))
+	{
+		// Large blocks, like the screenshot, bypass the chunk buffer.
+		if (m_file.is_open() && !m_file.write(buffer, count))
+			m_failed = true;
+		m_chunkOffset += count;
+	}
+	else
+	{
+		memcpy(m_cursor, buffer, static_cast<size_t>(count));
+		m_cursor += count;
+	}
+}
+
+static thread_local DysonSphereParser::MonotonicArena* currentArena = nullptr;
+
+DysonSphereParser::MonotonicArena::MonotonicArena() :
+	m_cursor(nullptr),
+	m_end(nullptr),
+	m_nextBlockSize(initialBlockSize),
+	m_bytesAllocated(0)
+{
+}
+
+void* DysonSphereParser::MonotonicArena::allocate(const size_t bytes, const size_t alignment)
+{
+	size_t padding = (alignment - reinterpret_cast<uintptr_t>(m_cursor) % alignment) % alignment;
+	if (static_cast<size_t>(m_end - m_cursor) < padding + bytes)
+	{
+		const size_t blockSize = std::max(m_nextBlockSize, bytes + alignment);
+		m_blocks.emplace_back(new char[blockSize]);
+		m_cursor = m_blocks.back().get();
+		m_end = m_cursor + blockSize;
+		if (m_nextBlockSize < maximumBlockSize)
+			m_nextBlockSize *= 2;
+		padding = (alignment - reinterpret_cast<uintptr_t>(m_cursor) % alignment) % alignment;
+	}
+
+	char* const result = m_cursor + padding;
+	m_cursor = result + bytes;
+	m_bytesAllocated += bytes;
+	return result;
+}
+
+DysonSphereParser::MonotonicArena* DysonSphereParser::MonotonicArena::createChild()
+{
+	std::lock_guard<std::mutex> lock(m_childrenMutex);
+	m_children.emplace_back(new MonotonicArena());
+	return m_children.back().get();
+}
+
+int64_t DysonSphereParser::MonotonicArena::bytesAllocated() const
+{
+	std::lock_guard<std::mutex> lock(m_childrenMutex);
+	int64_t total = m_bytesAllocated;
+	for (const auto& child : m_children)
+		total += child->bytesAllocated();
+	return total;
+}
+
+DysonSphereParser::MonotonicArena* DysonSphereParser::MonotonicArena::current()
+{
+	return currentArena;
+}
+
+DysonSphereParser::MonotonicArena* DysonSphereParser::MonotonicArena::createCurrentChild()
+{
+	return currentArena != nullptr ? currentArena->createChild() : nullptr;
+}
+
+DysonSphereParser::ArenaScope::ArenaScope(MonotonicArena* const arena) :
+	m_previous(currentArena)
+{
+	currentArena = arena;
+}
+
+DysonSphereParser::ArenaScope::~ArenaScope()
+{
+	currentArena = m_previous;
+}
 
 DysonSphereParser::IntVector2::IntVector2() :
 	x(0),
@@ -17,10 +645,14 @@ DysonSphereParser::IntVector2::IntVector2() :
 {
 }
 
-void DysonSphereParser::IntVector2::parse(std::ifstream& strm)
+void DysonSphereParser::IntVector2::parse(InputStream& strm)
 {
-	read(strm, x);
-	read(strm, y);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::IntVector2::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::Vector3::Vector3() :
@@ -30,11 +662,14 @@ DysonSphereParser::Vector3::Vector3() :
 {
 }
 
-void DysonSphereParser::Vector3::parse(std::ifstream& strm)
+void DysonSphereParser::Vector3::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::Vector3::serialize(OutputStream& strm) const
 {
-	read(strm, x);
-	read(strm, y);
-	read(strm, z);
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::VectorLF3::VectorLF3() :
@@ -44,11 +679,14 @@ DysonSphereParser::VectorLF3::VectorLF3() :
 {
 }
 
-void DysonSphereParser::VectorLF3::parse(std::ifstream& strm)
+void DysonSphereParser::VectorLF3::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::VectorLF3::serialize(OutputStream& strm) const
 {
-	read(strm, x);
-	read(strm, y);
-	read(strm, z);
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::Quaternion::Quaternion() :
@@ -59,12 +697,14 @@ DysonSphereParser::Quaternion::Quaternion() :
 {
 }
 
-void DysonSphereParser::Quaternion::parse(std::ifstream& strm)
+void DysonSphereParser::Quaternion::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::Quaternion::serialize(OutputStream& strm) const
 {
-	read(strm, x);
-	read(strm, y);
-	read(strm, z);
-	read(strm, w);
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::GameDesc::GameDesc() :
@@ -78,21 +718,14 @@ DysonSphereParser::GameDesc::GameDesc() :
 {
 }
 
-void DysonSphereParser::GameDesc::parse(std::ifstream& strm)
+void DysonSphereParser::GameDesc::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 2)
-	{
-		assert(false);
-		throw std::exception("Unexpected GameDesc version");
-	}
-	read(strm, galaxyAlgo);
-	read(strm, galaxySeed);
-	read(strm, starCount);
-	read(strm, playerProto);
-	read(strm, resourceMultiplier);
-	read(strm, numThemeIds);
-	read(strm, themeIds, numThemeIds);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::GameDesc::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::GamePrefsData::GamePrefsData() :
@@ -108,26 +741,14 @@ DysonSphereParser::GamePrefsData::GamePrefsData() :
 {
 }
 
-void DysonSphereParser::GamePrefsData::parse(std::ifstream& strm)
+void DysonSphereParser::GamePrefsData::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 2)
-	{
-		assert(false);
-		throw std::exception("Unexpected GamePrefsData version");
-	}
-	cameraUPos.parse(strm);
-	cameraURot.parse(strm);
-	read(strm, reformCursorSize);
-	read(strm, numReplicatorMultipliers);
-	read(strm, replicatorMultipliers, numReplicatorMultipliers);
-	read(strm, detailPower);
-	read(strm, detailVein);
-	read(strm, detailSpaceGuide);
-	read(strm, detailSign);
-	read(strm, detailIcon);
-	read(strm, numTutorialShowing);
-	read(strm, tutorialShowing, numTutorialShowing);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::GamePrefsData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::TechState::TechState() :
@@ -140,14 +761,14 @@ DysonSphereParser::TechState::TechState() :
 {
 }
 
-void DysonSphereParser::TechState::parse(std::ifstream& strm)
+void DysonSphereParser::TechState::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::TechState::serialize(OutputStream& strm) const
 {
-	read(strm, techProtoIndex);
-	read(strm, unlocked);
-	read(strm, curLevel);
-	read(strm, maxLevel);
-	read(strm, hashUploaded);
-	read(strm, hashNeeded);
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::GameHistoryData::GameHistoryData() :
@@ -183,26 +804,21 @@ DysonSphereParser::GameHistoryData::GameHistoryData() :
 {
 }
 
-void DysonSphereParser::GameHistoryData::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::GameHistoryData::parseVersion<2>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 2)
-	{
-		assert(false);
-		throw std::exception("Unexpected GameHistoryData version");
-	}
 	read(strm, numRecipeUnlocked);
-	read(strm, recipeUnlocked, numRecipeUnlocked);
+	read(strm, recipeUnlocked, numRecipeUnlocked, "GameHistoryData", "recipeUnlocked");
 	read(strm, numTutorialUnlocked);
-	read(strm, tutorialUnlocked, numTutorialUnlocked);
+	read(strm, tutorialUnlocked, numTutorialUnlocked, "GameHistoryData", "tutorialUnlocked");
 	read(strm, numFeatureKeys);
-	read(strm, featureKeys, numFeatureKeys);
+	read(strm, featureKeys, numFeatureKeys, "GameHistoryData", "featureKeys");
 	read(strm, numTechState);
-	readv(strm, techStates, numTechState);
+	readv(strm, techStates, numTechState, "GameHistoryData", "techStates");
 	read(strm, autoManageLabItems);
 	read(strm, currentTech);
 	read(strm, numTechQueue);
-	read(strm, techQueue, numTechQueue);
+	read(strm, techQueue, numTechQueue, "GameHistoryData", "techQueue");
 	read(strm, universeObserveLevel);
 	read(strm, solarSailLife);
 	read(strm, solarEnergyLossRate);
@@ -226,6 +842,57 @@ void DysonSphereParser::GameHistoryData::parse(std::ifstream& strm)
 	read(strm, missionAccomplished);
 }
 
+void DysonSphereParser::GameHistoryData::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("GameHistoryData", "version");
+}
+
+template<>
+void DysonSphereParser::GameHistoryData::serializeVersion<2>(OutputStream& strm) const
+{
+	write(strm, numRecipeUnlocked);
+	write(strm, recipeUnlocked);
+	write(strm, numTutorialUnlocked);
+	write(strm, tutorialUnlocked);
+	write(strm, numFeatureKeys);
+	write(strm, featureKeys);
+	write(strm, numTechState);
+	writev(strm, techStates);
+	write(strm, autoManageLabItems);
+	write(strm, currentTech);
+	write(strm, numTechQueue);
+	write(strm, techQueue);
+	write(strm, universeObserveLevel);
+	write(strm, solarSailLife);
+	write(strm, solarEnergyLossRate);
+	write(strm, useIonLayer);
+	write(strm, inserterStackCount);
+	write(strm, logisticDroneSpeed);
+	write(strm, logisticDroneSpeedScale);
+	write(strm, logisticDroneCarries);
+	write(strm, logisticShipSailSpeed);
+	write(strm, logisticShipWarpSpeed);
+	write(strm, logisticShipSpeedScale);
+	write(strm, logisticShipWarpDrive);
+	write(strm, logisticShipCarries);
+	write(strm, miningCostRate);
+	write(strm, miningSpeedScale);
+	write(strm, storageLevel);
+	write(strm, labLevel);
+	write(strm, techSpeed);
+	write(strm, dysonNodeLatitude);
+	write(strm, universeMatrixPointUploaded);
+	write(strm, missionAccomplished);
+}
+
+void DysonSphereParser::GameHistoryData::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
 DysonSphereParser::ProductStat::ProductStat() :
 	version(0),
 	numCount(0),
@@ -235,21 +902,14 @@ DysonSphereParser::ProductStat::ProductStat() :
 {
 }
 
-void DysonSphereParser::ProductStat::parse(std::ifstream& strm)
+void DysonSphereParser::ProductStat::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected ProductStat version");
-	}
-	read(strm, numCount);
-	read(strm, count, numCount);
-	read(strm, numCursor);
-	read(strm, cursor, numCursor);
-	read(strm, numTotal);
-	read(strm, total, numTotal);
-	read(strm, itemId);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::ProductStat::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::PowerStat::PowerStat() :
@@ -261,20 +921,14 @@ DysonSphereParser::PowerStat::PowerStat() :
 {
 }
 
-void DysonSphereParser::PowerStat::parse(std::ifstream& strm)
+void DysonSphereParser::PowerStat::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PowerStat version");
-	}
-	read(strm, numEnergy);
-	read(strm, energy, numEnergy);
-	read(strm, numCursor);
-	read(strm, cursor, numCursor);
-	read(strm, numTotal);
-	read(strm, total, numTotal);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::PowerStat::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::FactoryProductionStat::FactoryProductionStat() :
@@ -287,29 +941,47 @@ DysonSphereParser::FactoryProductionStat::FactoryProductionStat() :
 {
 }
 
-void DysonSphereParser::FactoryProductionStat::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::FactoryProductionStat::parseVersion<1>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 1)
-	{
-		assert(false);
-		throw std::exception("Unexpected FactoryProductionStat version");
-	}
 	read(strm, productCapacity);
 	read(strm, productCursor);
-	readv(strm, productPool, productCursor - 1);
+	visitv(strm, productPool, productCursor - 1, &ParseVisitor::onProductStat, "FactoryProductionStat", "productPool");
 	read(strm, numPowerPool);
 	if (numPowerPool > 5)
-	{
-		assert(false);
-		throw std::exception("Unexpected FactoryProductionStat numPowerPool");
-	}
-	readv(strm, powerPool, numPowerPool);
+		strm.fail("FactoryProductionStat", "numPowerPool");
+	readv(strm, powerPool, numPowerPool, "FactoryProductionStat", "powerPool");
 	read(strm, numProductIndices);
-	read(strm, productIndices, numProductIndices);
+	read(strm, productIndices, numProductIndices, "FactoryProductionStat", "productIndices");
 	read(strm, energyConsumption);
 }
 
+void DysonSphereParser::FactoryProductionStat::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("FactoryProductionStat", "version");
+}
+
+template<>
+void DysonSphereParser::FactoryProductionStat::serializeVersion<1>(OutputStream& strm) const
+{
+	write(strm, productCapacity);
+	write(strm, productCursor);
+	writev(strm, productPool);
+	write(strm, numPowerPool);
+	writev(strm, powerPool);
+	write(strm, numProductIndices);
+	write(strm, productIndices);
+	write(strm, energyConsumption);
+}
+
+void DysonSphereParser::FactoryProductionStat::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
 DysonSphereParser::ProductionStatistics::ProductionStatistics() :
 	version(0),
 	numFactoryStatPool(0),
@@ -318,20 +990,39 @@ DysonSphereParser::ProductionStatistics::ProductionStatistics() :
 {
 }
 
-void DysonSphereParser::ProductionStatistics::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::ProductionStatistics::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected ProductionStatistics version");
-	}
 	read(strm, numFactoryStatPool);
-	readv(strm, factoryStatPool, numFactoryStatPool);
+	readv(strm, factoryStatPool, numFactoryStatPool, "ProductionStatistics", "factoryStatPool");
 	read(strm, numFirstCreateIds);
-	read(strm, firstCreateIds, numFirstCreateIds);
+	read(strm, firstCreateIds, numFirstCreateIds, "ProductionStatistics", "firstCreateIds");
 	read(strm, numFavoriteIds);
-	read(strm, favoriteIds, numFavoriteIds);
+	read(strm, favoriteIds, numFavoriteIds, "ProductionStatistics", "favoriteIds");
+}
+
+void DysonSphereParser::ProductionStatistics::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("ProductionStatistics", "version");
+}
+
+template<>
+void DysonSphereParser::ProductionStatistics::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, numFactoryStatPool);
+	writev(strm, factoryStatPool);
+	write(strm, numFirstCreateIds);
+	write(strm, firstCreateIds);
+	write(strm, numFavoriteIds);
+	write(strm, favoriteIds);
+}
+
+void DysonSphereParser::ProductionStatistics::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
 }
 
 DysonSphereParser::GameStatData::GameStatData() :
@@ -340,19 +1031,35 @@ DysonSphereParser::GameStatData::GameStatData() :
 {
 }
 
-void DysonSphereParser::GameStatData::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::GameStatData::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected GameStatData version");
-	}
 	read(strm, numTechHashedHistory);
-	read(strm, techHashedHistory, numTechHashedHistory);
+	read(strm, techHashedHistory, numTechHashedHistory, "GameStatData", "techHashedHistory");
 	production.parse(strm);
 }
 
+void DysonSphereParser::GameStatData::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("GameStatData", "version");
+}
+
+template<>
+void DysonSphereParser::GameStatData::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, numTechHashedHistory);
+	write(strm, techHashedHistory);
+	production.serialize(strm);
+}
+
+void DysonSphereParser::GameStatData::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
 DysonSphereParser::StorageComponent::StorageComponent() :
 	version(0),
 	id(0),
@@ -367,14 +1074,9 @@ DysonSphereParser::StorageComponent::StorageComponent() :
 {
 }
 
-void DysonSphereParser::StorageComponent::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::StorageComponent::parseVersion<1>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 1)
-	{
-		assert(false);
-		throw std::exception("Unexpected StorageComponent version");
-	}
 	read(strm, id);
 	read(strm, entityId);
 	read(strm, previous);
@@ -384,6 +1086,8 @@ void DysonSphereParser::StorageComponent::parse(std::ifstream& strm)
 	read<DysonSphereParser::StorageComponent::EStorageType, int32_t>(strm, type);
 	read(strm, gridSize);
 	read(strm, bans);
+	if (!strm.checkCount(gridSize, sizeof(GRID), "StorageComponent", "grids"))
+		return;
 	grids.resize(gridSize);
 	for (auto it = grids.begin(); it != grids.end(); ++it)
 	{
@@ -394,6 +1098,50 @@ void DysonSphereParser::StorageComponent::parse(std::ifstream& strm)
 	}
 }
 
+void DysonSphereParser::StorageComponent::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("StorageComponent", "version");
+}
+
+template<>
+void DysonSphereParser::StorageComponent::serializeVersion<1>(OutputStream& strm) const
+{
+	write(strm, id);
+	write(strm, entityId);
+	write(strm, previous);
+	write(strm, next);
+	write(strm, bottom);
+	write(strm, top);
+	write<DysonSphereParser::StorageComponent::EStorageType, int32_t>(strm, type);
+	write(strm, gridSize);
+	write(strm, bans);
+	for (auto it = grids.begin(); it != grids.end(); ++it)
+	{
+		write(strm, it->itemId);
+		write(strm, it->filter);
+		write(strm, it->count);
+		write(strm, it->stackSize);
+	}
+}
+
+void DysonSphereParser::StorageComponent::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::StorageComponent::skip(InputStream& strm)
+{
+	int32_t gridSize = 0;
+	strm.skip(32);  // version, id, entityId, previous, next, bottom, top, type
+	read(strm, gridSize);
+	strm.skip(4);  // bans
+	if (gridSize > 0)
+		strm.skip(static_cast<int64_t>(gridSize) * 16);
+}
+
 DysonSphereParser::ForgeTask::ForgeTask() :
 	version(0),
 	recipeId(0),
@@ -406,41 +1154,78 @@ DysonSphereParser::ForgeTask::ForgeTask() :
 {
 }
 
-void DysonSphereParser::ForgeTask::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::ForgeTask::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected ForgeTask version");
-	}
 	read(strm, recipeId);
 	read(strm, count);
 	read(strm, tick);
 	read(strm, tickSpend);
 	read(strm, numItem);
 	read(strm, numProduct);
-	read(strm, itemIds, itemCounts, served, numItem);
-	read(strm, productIds, productCounts, produced, numProduct);
+	read(strm, itemIds, itemCounts, served, numItem, "ForgeTask", "itemIds");
+	read(strm, productIds, productCounts, produced, numProduct, "ForgeTask", "productIds");
 	read(strm, parentTaskIndex);
 }
 
+void DysonSphereParser::ForgeTask::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("ForgeTask", "version");
+}
+
+template<>
+void DysonSphereParser::ForgeTask::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, recipeId);
+	write(strm, count);
+	write(strm, tick);
+	write(strm, tickSpend);
+	write(strm, numItem);
+	write(strm, numProduct);
+	write(strm, itemIds, itemCounts, served);
+	write(strm, productIds, productCounts, produced);
+	write(strm, parentTaskIndex);
+}
+
+void DysonSphereParser::ForgeTask::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
 DysonSphereParser::MechaForge::MechaForge() :
 	version(0),
 	numTasks(0)
 {
 }
 
-void DysonSphereParser::MechaForge::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::MechaForge::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected MechaForge version");
-	}
 	read(strm, numTasks);
-	readv(strm, tasks, numTasks);
+	readv(strm, tasks, numTasks, "MechaForge", "tasks");
+}
+
+void DysonSphereParser::MechaForge::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("MechaForge", "version");
+}
+
+template<>
+void DysonSphereParser::MechaForge::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, numTasks);
+	writev(strm, tasks);
+}
+
+void DysonSphereParser::MechaForge::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
 }
 
 DysonSphereParser::MechaLab::MechaLab() :
@@ -449,16 +1234,14 @@ DysonSphereParser::MechaLab::MechaLab() :
 {
 }
 
-void DysonSphereParser::MechaLab::parse(std::ifstream& strm)
+void DysonSphereParser::MechaLab::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected MechaLab version");
-	}
-	read(strm, numItemPoints);
-	read(strm, itemPoints, numItemPoints);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::MechaLab::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::MechaDrone::MechaDrone() :
@@ -471,23 +1254,14 @@ DysonSphereParser::MechaDrone::MechaDrone() :
 {
 }
 
-void DysonSphereParser::MechaDrone::parse(std::ifstream& strm)
+void DysonSphereParser::MechaDrone::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected MechaDrone version");
-	}
-	read(strm, stage);
-	position.parse(strm);
-	target.parse(strm);
-	forward.parse(strm);
-	read(strm, speed);
-	read(strm, movement);
-	read(strm, targetObject);
-	read(strm, progress);
-	initialVector.parse(strm);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::MechaDrone::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::Mecha::Mecha() :
@@ -523,14 +1297,9 @@ DysonSphereParser::Mecha::Mecha() :
 {
 }
 
-void DysonSphereParser::Mecha::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::Mecha::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected Mecha version");
-	}
 	read(strm, coreEnergyCap);
 	read(strm, coreEnergy);
 	read(strm, corePowerGen);
@@ -563,7 +1332,58 @@ void DysonSphereParser::Mecha::parse(std::ifstream& strm)
 	read(strm, droneCount);
 	read(strm, droneSpeed);
 	read(strm, droneMovement);
-	readv(strm, drones, droneCount);
+	readv(strm, drones, droneCount, "Mecha", "drones");
+}
+
+void DysonSphereParser::Mecha::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("Mecha", "version");
+}
+
+template<>
+void DysonSphereParser::Mecha::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, coreEnergyCap);
+	write(strm, coreEnergy);
+	write(strm, corePowerGen);
+	write(strm, reactorPowerGen);
+	write(strm, reactorEnergy);
+	write(strm, reactorItemId);
+	reactorStorage.serialize(strm);
+	warpStorage.serialize(strm);
+	write(strm, walkPower);
+	write(strm, jumpEnergy);
+	write(strm, thrustPowerPerAcc);
+	write(strm, warpKeepingPowerPerSpeed);
+	write(strm, warpStartPowerPerSpeed);
+	write(strm, miningPower);
+	write(strm, replicatePower);
+	write(strm, researchPower);
+	write(strm, droneEjectEnergy);
+	write(strm, droneEnergyPerMeter);
+	write(strm, coreLevel);
+	write(strm, thrusterLevel);
+	write(strm, miningSpeed);
+	write(strm, replicateSpeed);
+	write(strm, walkSpeed);
+	write(strm, jumpSpeed);
+	write(strm, maxSailSpeed);
+	write(strm, maxWarpSpeed);
+	write(strm, buildArea);
+	forge.serialize(strm);
+	lab.serialize(strm);
+	write(strm, droneCount);
+	write(strm, droneSpeed);
+	write(strm, droneMovement);
+	writev(strm, drones);
+}
+
+void DysonSphereParser::Mecha::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
 }
 
 DysonSphereParser::PlayerNavigation::PlayerNavigation() :
@@ -581,25 +1401,14 @@ DysonSphereParser::PlayerNavigation::PlayerNavigation() :
 {
 }
 
-void DysonSphereParser::PlayerNavigation::parse(std::ifstream& strm)
+void DysonSphereParser::PlayerNavigation::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PlayerNavigation version");
-	}
-	read(strm, navigating);
-	read(strm, naviAstroId);
-	naviTarget.parse(strm);
-	read(strm, useFly);
-	read(strm, useSail);
-	read(strm, useWarp);
-	read<DysonSphereParser::PlayerNavigation::ENaviStage, int32_t>(strm, stage);
-	read(strm, flyThreshold);
-	read(strm, sailThreshold);
-	read(strm, warpThreshold);
-	read(strm, maxSailSpeed);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::PlayerNavigation::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::Player::Player() :
@@ -614,14 +1423,9 @@ DysonSphereParser::Player::Player() :
 {
 }
 
-void DysonSphereParser::Player::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::Player::parseVersion<1>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 1)
-	{
-		assert(false);
-		throw std::exception("Unexpected Player version");
-	}
 	read(strm, planetId);
 	position.parse(strm);
 	uPosition.parse(strm);
@@ -638,19 +1442,51 @@ void DysonSphereParser::Player::parse(std::ifstream& strm)
 	read(strm, sandCount);
 }
 
+void DysonSphereParser::Player::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("Player", "version");
+}
+
+template<>
+void DysonSphereParser::Player::serializeVersion<1>(OutputStream& strm) const
+{
+	write(strm, planetId);
+	position.serialize(strm);
+	uPosition.serialize(strm);
+	uRotation.serialize(strm);
+	write<DysonSphereParser::Player::EMovementState, int32_t>(strm, movementState);
+	write(strm, warpState);
+	write(strm, warpCommand);
+	uVelocity.serialize(strm);
+	write(strm, inhandItemId);
+	write(strm, inhandItemCount);
+	mecha.serialize(strm);
+	package.serialize(strm);
+	navigation.serialize(strm);
+	write(strm, sandCount);
+}
+
+void DysonSphereParser::Player::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
 DysonSphereParser::GalacticTransport::GalacticTransport() :
 	version(0)
 {
 }
 
-void DysonSphereParser::GalacticTransport::parse(std::ifstream& strm)
+void DysonSphereParser::GalacticTransport::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected GalacticTransport version");
-	}
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::GalacticTransport::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
 }
 
 DysonSphereParser::VeinGroup::VeinGroup() :
@@ -660,12 +1496,19 @@ DysonSphereParser::VeinGroup::VeinGroup() :
 {
 }
 
-void DysonSphereParser::VeinGroup::parse(std::ifstream& strm)
+void DysonSphereParser::VeinGroup::parse(InputStream& strm)
 {
-	read<DysonSphereParser::EVeinType, int32_t>(strm, type);
-	pos.parse(strm);
-	read(strm, count);
-	read(strm, amount);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::VeinGroup::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::VeinGroup::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::PlanetData::PlanetData() :
@@ -675,14 +1518,37 @@ DysonSphereParser::PlanetData::PlanetData() :
 {
 }
 
-void DysonSphereParser::PlanetData::parse(std::ifstream& strm)
+void DysonSphereParser::PlanetData::parse(InputStream& strm)
+{
+	read(strm, modDataByteCount);
+	read(strm, modData, modDataByteCount, "PlanetData", "modData");
+	read(strm, numVeinAmounts);
+	read(strm, veinAmounts, numVeinAmounts, "PlanetData", "veinAmounts");
+	read(strm, numVeinGroups);
+	readv(strm, veinGroups, numVeinGroups, "PlanetData", "veinGroups");
+}
+
+void DysonSphereParser::PlanetData::serialize(OutputStream& strm) const
+{
+	write(strm, modDataByteCount);
+	write(strm, modData);
+	write(strm, numVeinAmounts);
+	write(strm, veinAmounts);
+	write(strm, numVeinGroups);
+	writev(strm, veinGroups);
+}
+
+void DysonSphereParser::PlanetData::skip(InputStream& strm)
 {
+	int32_t modDataByteCount = 0;
 	read(strm, modDataByteCount);
-	read(strm, modData, modDataByteCount);
+	skipArray<uint8_t>(strm, modDataByteCount);
+	int32_t numVeinAmounts = 0;
 	read(strm, numVeinAmounts);
-	read(strm, veinAmounts, numVeinAmounts);
+	skipArray<int64_t>(strm, numVeinAmounts);
+	int32_t numVeinGroups = 0;
 	read(strm, numVeinGroups);
-	readv(strm, veinGroups, numVeinGroups);
+	skipv<VeinGroup>(strm, numVeinGroups, "PlanetData", "veinGroups");
 }
 
 DysonSphereParser::EntityData::EntityData() :
@@ -711,37 +1577,98 @@ DysonSphereParser::EntityData::EntityData() :
 {
 }
 
-void DysonSphereParser::EntityData::parse(std::ifstream& strm)
+void DysonSphereParser::EntityData::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::EntityData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::EntityData::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
+}
+
+DysonSphereParser::EntityTable::EntityTable()
+{
+}
+
+void DysonSphereParser::EntityTable::build(const Vector<EntityData>& entities)
+{
+	const size_t count = entities.size();
+	id.resize(count);
+	protoId.resize(count);
+	modelIndex.resize(count);
+	pos.resize(count);
+	rot.resize(count);
+	beltId.resize(count);
+	splitterId.resize(count);
+	storageId.resize(count);
+	tankId.resize(count);
+	minerId.resize(count);
+	inserterId.resize(count);
+	assemblerId.resize(count);
+	fractionateId.resize(count);
+	ejectorId.resize(count);
+	siloId.resize(count);
+	labId.resize(count);
+	stationId.resize(count);
+	powerNodeId.resize(count);
+	powerGenId.resize(count);
+	powerConId.resize(count);
+	powerAccId.resize(count);
+	powerExcId.resize(count);
+	monsterId.resize(count);
+
+	for (size_t row = 0; row < count; ++row)
 	{
-		assert(false);
-		throw std::exception("Unexpected EntityData version");
+		const EntityData& entity = entities[row];
+		id[row] = entity.id;
+		protoId[row] = entity.protoId;
+		modelIndex[row] = entity.modelIndex;
+		pos[row] = entity.pos;
+		rot[row] = entity.rot;
+		beltId[row] = entity.beltId;
+		splitterId[row] = entity.splitterId;
+		storageId[row] = entity.storageId;
+		tankId[row] = entity.tankId;
+		minerId[row] = entity.minerId;
+		inserterId[row] = entity.inserterId;
+		assemblerId[row] = entity.assemblerId;
+		fractionateId[row] = entity.fractionateId;
+		ejectorId[row] = entity.ejectorId;
+		siloId[row] = entity.siloId;
+		labId[row] = entity.labId;
+		stationId[row] = entity.stationId;
+		powerNodeId[row] = entity.powerNodeId;
+		powerGenId[row] = entity.powerGenId;
+		powerConId[row] = entity.powerConId;
+		powerAccId[row] = entity.powerAccId;
+		powerExcId[row] = entity.powerExcId;
+		monsterId[row] = entity.monsterId;
 	}
-	read(strm, id);
-	read(strm, protoId);
-	read(strm, modelIndex);
-	pos.parse(strm);
-	rot.parse(strm);
-	read(strm, beltId);
-	read(strm, splitterId);
-	read(strm, storageId);
-	read(strm, tankId);
-	read(strm, minerId);
-	read(strm, inserterId);
-	read(strm, assemblerId);
-	read(strm, fractionateId);
-	read(strm, ejectorId);
-	read(strm, siloId);
-	read(strm, labId);
-	read(strm, stationId);
-	read(strm, powerNodeId);
-	read(strm, powerGenId);
-	read(strm, powerConId);
-	read(strm, powerAccId);
-	read(strm, powerExcId);
-	read(strm, monsterId);
+}
+
+void DysonSphereParser::EntityTable::clear()
+{
+	*this = EntityTable();
+}
+
+std::vector<int32_t> DysonSphereParser::EntityTable::countByProto() const
+{
+	std::vector<int32_t> counts;
+	for (const int16_t proto : protoId)
+	{
+		if (proto < 0)
+			continue;
+		if (static_cast<size_t>(proto) >= counts.size())
+			counts.resize(proto + 1);
+		++counts[proto];
+	}
+	return counts;
 }
 
 DysonSphereParser::AnimData::AnimData() :
@@ -753,13 +1680,19 @@ DysonSphereParser::AnimData::AnimData() :
 {
 }
 
-void DysonSphereParser::AnimData::parse(std::ifstream& strm)
+void DysonSphereParser::AnimData::parse(InputStream& strm)
 {
-	read(strm, time);
-	read(strm, prepare_length);
-	read(strm, working_length);
-	read(strm, state);
-	read(strm, power);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::AnimData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::AnimData::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::SignData::SignData() :
@@ -780,22 +1713,19 @@ DysonSphereParser::SignData::SignData() :
 {
 }
 
-void DysonSphereParser::SignData::parse(std::ifstream& strm)
+void DysonSphereParser::SignData::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::SignData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::SignData::skip(InputStream& strm)
 {
-	read(strm, signType);
-	read(strm, iconType);
-	read(strm, iconId0);
-	read(strm, iconId1);
-	read(strm, iconId2);
-	read(strm, iconId3);
-	read(strm, count0);
-	read(strm, count1);
-	read(strm, count2);
-	read(strm, count3);
-	read(strm, x);
-	read(strm, y);
-	read(strm, z);
-	read(strm, w);
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::PrebuildData::PrebuildData() :
@@ -812,28 +1742,19 @@ DysonSphereParser::PrebuildData::PrebuildData() :
 {
 }
 
-void DysonSphereParser::PrebuildData::parse(std::ifstream& strm)
+void DysonSphereParser::PrebuildData::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PrebuildData version");
-	}
-	read(strm, id);
-	read(strm, protoId);
-	read(strm, modelIndex);
-	pos.parse(strm);
-	rot.parse(strm);
-	pos2.parse(strm);
-	rot2.parse(strm);
-	read(strm, upEntity);
-	read(strm, pickOffset);
-	read(strm, insertOffset);
-	read(strm, recipeId);
-	read(strm, filterId);
-	read(strm, refCount);
-	read(strm, refArr, refCount);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::PrebuildData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::PrebuildData::skip(InputStream& strm)
+{
+	schemaSkip<PrebuildData>(strm);
 }
 
 DysonSphereParser::VegeData::VegeData() :
@@ -845,21 +1766,19 @@ DysonSphereParser::VegeData::VegeData() :
 {
 }
 
-void DysonSphereParser::VegeData::parse(std::ifstream& strm)
+void DysonSphereParser::VegeData::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected VegeData version");
-	}
-	read(strm, id);
-	read(strm, protoId);
-	read(strm, modelIndex);
-	read(strm, hp);
-	pos.parse(strm);
-	rot.parse(strm);
-	scl.parse(strm);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::VegeData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::VegeData::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::VeinData::VeinData() :
@@ -878,26 +1797,19 @@ DysonSphereParser::VeinData::VeinData() :
 {
 }
 
-void DysonSphereParser::VeinData::parse(std::ifstream& strm)
+void DysonSphereParser::VeinData::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected VeinData version");
-	}
-	read(strm, id);
-	read<DysonSphereParser::EVeinType, int16_t>(strm, type);
-	read(strm, modelIndex);
-	read(strm, groupIndex);
-	read(strm, amount);
-	read(strm, productId);
-	pos.parse(strm);
-	read(strm, minerCount);
-	read(strm, minerId0);
-	read(strm, minerId1);
-	read(strm, minerId2);
-	read(strm, minerId3);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::VeinData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::VeinData::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::Cargo::Cargo() :
@@ -905,11 +1817,19 @@ DysonSphereParser::Cargo::Cargo() :
 {
 }
 
-void DysonSphereParser::Cargo::parse(std::ifstream& strm)
+void DysonSphereParser::Cargo::parse(InputStream& strm)
 {
-	read(strm, item);
-	position.parse(strm);
-	rotation.parse(strm);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::Cargo::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::Cargo::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::CargoContainer::CargoContainer() :
@@ -921,20 +1841,52 @@ DysonSphereParser::CargoContainer::CargoContainer() :
 {
 }
 
-void DysonSphereParser::CargoContainer::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::CargoContainer::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected CargoContainer version");
-	}
 	read(strm, poolCapacity);
 	read(strm, cursor);
 	read(strm, recycleBegin);
 	read(strm, recycleEnd);
-	readv(strm, cargoPool, cursor);
-	read(strm, recycleIds, poolCapacity);
+	readv(strm, cargoPool, cursor, "CargoContainer", "cargoPool");
+	read(strm, recycleIds, poolCapacity, "CargoContainer", "recycleIds");
+}
+
+void DysonSphereParser::CargoContainer::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("CargoContainer", "version");
+}
+
+template<>
+void DysonSphereParser::CargoContainer::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, poolCapacity);
+	write(strm, cursor);
+	write(strm, recycleBegin);
+	write(strm, recycleEnd);
+	writev(strm, cargoPool);
+	write(strm, recycleIds);
+}
+
+void DysonSphereParser::CargoContainer::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::CargoContainer::skip(InputStream& strm)
+{
+	int32_t version = 0;
+	int32_t poolCapacity = 0;
+	int32_t cursor = 0;
+	read(strm, version);
+	read(strm, poolCapacity);
+	read(strm, cursor);
+	strm.skip(8);  // recycleBegin, recycleEnd
+	skipv<Cargo>(strm, cursor, "CargoContainer", "cargoPool");
+	skipArray<int32_t>(strm, poolCapacity);
 }
 
 DysonSphereParser::BeltComponent::BeltComponent() :
@@ -953,25 +1905,19 @@ DysonSphereParser::BeltComponent::BeltComponent() :
 {
 }
 
-void DysonSphereParser::BeltComponent::parse(std::ifstream& strm)
+void DysonSphereParser::BeltComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected BeltComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, speed);
-	read(strm, segPathId);
-	read(strm, segIndex);
-	read(strm, segPivotOffset);
-	read(strm, segLength);
-	read(strm, outputId);
-	read(strm, backInputId);
-	read(strm, leftInputId);
-	read(strm, rightInputId);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::BeltComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::BeltComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::SplitterComponent::SplitterComponent() :
@@ -996,31 +1942,19 @@ DysonSphereParser::SplitterComponent::SplitterComponent() :
 {
 }
 
-void DysonSphereParser::SplitterComponent::parse(std::ifstream& strm)
+void DysonSphereParser::SplitterComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected SplitterComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, beltA);
-	read(strm, beltB);
-	read(strm, beltC);
-	read(strm, beltD);
-	read(strm, input0);
-	read(strm, input1);
-	read(strm, input2);
-	read(strm, input3);
-	read(strm, output0);
-	read(strm, output1);
-	read(strm, output2);
-	read(strm, output3);
-	read(strm, inPriority);
-	read(strm, outPriority);
-	read(strm, outFilter);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::SplitterComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::SplitterComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::CargoPath::CargoPath() :
@@ -1039,14 +1973,9 @@ DysonSphereParser::CargoPath::CargoPath() :
 {
 }
 
-void DysonSphereParser::CargoPath::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::CargoPath::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected CargoPath version");
-	}
 	read(strm, id);
 	read(strm, capacity);
 	read(strm, bufferLength);
@@ -1059,13 +1988,71 @@ void DysonSphereParser::CargoPath::parse(std::ifstream& strm)
 	read(strm, numBelts);
 	read(strm, numInputPaths);
 
-	buffer.resize(bufferLength);
-	strm.read(reinterpret_cast<char*>(buffer.data()), bufferLength);
+	read(strm, buffer, bufferLength, "CargoPath", "buffer");
+	if (chunkCount >= 0 && chunkCount <= INT32_MAX / 3)
+		read(strm, chunks, chunkCount * 3, "CargoPath", "chunks");
+	else
+		strm.fail("CargoPath", "chunks");
+	readv(strm, pointPos, pointRot, bufferLength, "CargoPath", "pointPos");
+	read(strm, belts, numBelts, "CargoPath", "belts");
+	read(strm, inputPaths, numInputPaths, "CargoPath", "inputPaths");
+}
+
+void DysonSphereParser::CargoPath::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("CargoPath", "version");
+}
+
+template<>
+void DysonSphereParser::CargoPath::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, id);
+	write(strm, capacity);
+	write(strm, bufferLength);
+	write(strm, chunkCapacity);
+	write(strm, chunkCount);
+	write(strm, updateLen);
+	write(strm, closed);
+	write(strm, outputPathIdForImport);
+	write(strm, outputIndex);
+	write(strm, numBelts);
+	write(strm, numInputPaths);
+
+	write(strm, buffer);
+	write(strm, chunks);
+	writev(strm, pointPos, pointRot);
+	write(strm, belts);
+	write(strm, inputPaths);
+}
+
+void DysonSphereParser::CargoPath::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
 
-	read(strm, chunks, chunkCount * 3);
-	readv(strm, pointPos, pointRot, bufferLength);
-	read(strm, belts, numBelts);
-	read(strm, inputPaths, numInputPaths);
+void DysonSphereParser::CargoPath::skip(InputStream& strm)
+{
+	int32_t bufferLength = 0;
+	int32_t chunkCount = 0;
+	int32_t numBelts = 0;
+	int32_t numInputPaths = 0;
+	strm.skip(12);  // version, id, capacity
+	read(strm, bufferLength);
+	strm.skip(4);  // chunkCapacity
+	read(strm, chunkCount);
+	strm.skip(13);  // updateLen, closed, outputPathIdForImport, outputIndex
+	read(strm, numBelts);
+	read(strm, numInputPaths);
+	skipArray<uint8_t>(strm, bufferLength);
+	if (chunkCount > 0)
+		strm.skip(static_cast<int64_t>(chunkCount) * 12);  // chunks
+	if (bufferLength > 0)
+		strm.skip(static_cast<int64_t>(bufferLength) * 28);  // pointPos, pointRot
+	skipArray<int32_t>(strm, numBelts);
+	skipArray<int32_t>(strm, numInputPaths);
 }
 
 DysonSphereParser::CargoTraffic::CargoTraffic() :
@@ -1082,14 +2069,72 @@ DysonSphereParser::CargoTraffic::CargoTraffic() :
 {
 }
 
-void DysonSphereParser::CargoTraffic::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::CargoTraffic::parseVersion<0>(InputStream& strm)
+{
+	read(strm, beltCursor);
+	read(strm, beltCapacity);
+	read(strm, beltRecycleCursor);
+	read(strm, splitterCursor);
+	read(strm, splitterCapacity);
+	read(strm, splitterRecycleCursor);
+	read(strm, pathCursor);
+	read(strm, pathCapacity);
+	read(strm, pathRecycleCursor);
+	visitv(strm, beltPool, beltCursor - 1, &ParseVisitor::onBelt, "CargoTraffic", "beltPool");
+	read(strm, beltRecycle, beltRecycleCursor, "CargoTraffic", "beltRecycle");
+	readv(strm, splitterPool, splitterCursor - 1, "CargoTraffic", "splitterPool");
+	read(strm, splitterRecycle, splitterRecycleCursor, "CargoTraffic", "splitterRecycle");
+	readi(strm, cargoPathIndex, pathPool, pathCursor - 1, "CargoTraffic", "pathPool");
+	read(strm, pathRecycle, pathRecycleCursor, "CargoTraffic", "pathRecycle");
+}
+
+void DysonSphereParser::CargoTraffic::parse(InputStream& strm)
 {
 	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected CargoTraffic version");
-	}
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("CargoTraffic", "version");
+}
+
+template<>
+void DysonSphereParser::CargoTraffic::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, beltCursor);
+	write(strm, beltCapacity);
+	write(strm, beltRecycleCursor);
+	write(strm, splitterCursor);
+	write(strm, splitterCapacity);
+	write(strm, splitterRecycleCursor);
+	write(strm, pathCursor);
+	write(strm, pathCapacity);
+	write(strm, pathRecycleCursor);
+	writev(strm, beltPool);
+	write(strm, beltRecycle);
+	writev(strm, splitterPool);
+	write(strm, splitterRecycle);
+	writei(strm, cargoPathIndex, pathPool, pathCursor - 1);
+	write(strm, pathRecycle);
+}
+
+void DysonSphereParser::CargoTraffic::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::CargoTraffic::skip(InputStream& strm)
+{
+	int32_t version = 0;
+	int32_t beltCursor = 0;
+	int32_t beltCapacity = 0;
+	int32_t beltRecycleCursor = 0;
+	int32_t splitterCursor = 0;
+	int32_t splitterCapacity = 0;
+	int32_t splitterRecycleCursor = 0;
+	int32_t pathCursor = 0;
+	int32_t pathCapacity = 0;
+	int32_t pathRecycleCursor = 0;
+	read(strm, version);
 	read(strm, beltCursor);
 	read(strm, beltCapacity);
 	read(strm, beltRecycleCursor);
@@ -1099,12 +2144,12 @@ void DysonSphereParser::CargoTraffic::parse(std::ifstream& strm)
 	read(strm, pathCursor);
 	read(strm, pathCapacity);
 	read(strm, pathRecycleCursor);
-	readv(strm, beltPool, beltCursor - 1);
-	read(strm, beltRecycle, beltRecycleCursor);
-	readv(strm, splitterPool, splitterCursor - 1);
-	read(strm, splitterRecycle, splitterRecycleCursor);
-	readi(strm, cargoPathIndex, pathPool, pathCursor - 1);
-	read(strm, pathRecycle, pathRecycleCursor);
+	skipv<BeltComponent>(strm, beltCursor - 1, "CargoTraffic", "beltPool");
+	skipArray<int32_t>(strm, beltRecycleCursor);
+	skipv<SplitterComponent>(strm, splitterCursor - 1, "CargoTraffic", "splitterPool");
+	skipArray<int32_t>(strm, splitterRecycleCursor);
+	skipi<CargoPath>(strm, pathCursor - 1, "CargoTraffic", "pathPool");
+	skipArray<int32_t>(strm, pathRecycleCursor);
 }
 
 DysonSphereParser::TankComponent::TankComponent() :
@@ -1130,32 +2175,19 @@ DysonSphereParser::TankComponent::TankComponent() :
 {
 }
 
-void DysonSphereParser::TankComponent::parse(std::ifstream& strm)
+void DysonSphereParser::TankComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected TankComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, lastTankId);
-	read(strm, nextTankId);
-	read(strm, belt0);
-	read(strm, belt1);
-	read(strm, belt2);
-	read(strm, belt3);
-	read(strm, isOutput0);
-	read(strm, isOutput1);
-	read(strm, isOutput2);
-	read(strm, isOutput3);
-	read(strm, fluidStorageCount);
-	read(strm, currentCount);
-	read(strm, fluidId);
-	read(strm, outputSwitch);
-	read(strm, inputSwitch);
-	read(strm, isBottom);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::TankComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::TankComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::FactoryStorage::FactoryStorage() :
@@ -1169,17 +2201,14 @@ DysonSphereParser::FactoryStorage::FactoryStorage() :
 {
 }
 
-void DysonSphereParser::FactoryStorage::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::FactoryStorage::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected FactoryStorage version");
-	}
 	read(strm, storageCursor);
 	read(strm, storageCapacity);
 	read(strm, storageRecycleCursor);
+	if (storageCursor > 1 && !strm.checkCount(storageCursor - 1, sizeof(int32_t), "FactoryStorage", "storagePool"))
+		return;
 	for (int32_t i = 0; i < storageCursor - 1; ++i)
 	{
 		int32_t index = 0;
@@ -1193,12 +2222,87 @@ void DysonSphereParser::FactoryStorage::parse(std::ifstream& strm)
 			storagePool.rbegin()->parse(strm);
 		}
 	}
-	read(strm, storageRecycle, storageRecycleCursor);
+	read(strm, storageRecycle, storageRecycleCursor, "FactoryStorage", "storageRecycle");
+	read(strm, tankCapacity);
+	read(strm, tankCursor);
+	read(strm, tankRecycleCursor);
+	readv(strm, tankPool, tankCursor - 1, "FactoryStorage", "tankPool");
+	read(strm, tankRecycle, tankRecycleCursor, "FactoryStorage", "tankRecycle");
+}
+
+void DysonSphereParser::FactoryStorage::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("FactoryStorage", "version");
+}
+
+template<>
+void DysonSphereParser::FactoryStorage::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, storageCursor);
+	write(strm, storageCapacity);
+	write(strm, storageRecycleCursor);
+	size_t next = 0;
+	for (int32_t i = 0; i < storageCursor - 1; ++i)
+	{
+		if (next < storagePool.size() && isSlotOf(storagePoolIndex[next], i, storageCursor - 1, storagePool.size() - next))
+		{
+			write(strm, storagePoolIndex[next]);
+			write(strm, storagePoolSize[next]);
+			storagePool[next].serialize(strm);
+			++next;
+		}
+		else
+		{
+			write(strm, int32_t(0));
+		}
+	}
+	write(strm, storageRecycle);
+	write(strm, tankCapacity);
+	write(strm, tankCursor);
+	write(strm, tankRecycleCursor);
+	writev(strm, tankPool);
+	write(strm, tankRecycle);
+}
+
+void DysonSphereParser::FactoryStorage::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::FactoryStorage::skip(InputStream& strm)
+{
+	int32_t version = 0;
+	int32_t storageCursor = 0;
+	int32_t storageCapacity = 0;
+	int32_t storageRecycleCursor = 0;
+	read(strm, version);
+	read(strm, storageCursor);
+	read(strm, storageCapacity);
+	read(strm, storageRecycleCursor);
+	if (storageCursor > 1 && !strm.checkCount(storageCursor - 1, sizeof(int32_t), "FactoryStorage", "storagePool"))
+		return;
+	for (int32_t i = 0; i < storageCursor - 1 && strm; ++i)
+	{
+		int32_t index = 0;
+		read(strm, index);
+		if (index != 0)
+		{
+			strm.skip(4);  // storagePoolSize
+			StorageComponent::skip(strm);
+		}
+	}
+	skipArray<int32_t>(strm, storageRecycleCursor);
+	int32_t tankCapacity = 0;
+	int32_t tankCursor = 0;
+	int32_t tankRecycleCursor = 0;
 	read(strm, tankCapacity);
 	read(strm, tankCursor);
 	read(strm, tankRecycleCursor);
-	readv(strm, tankPool, tankCursor - 1);
-	read(strm, tankRecycle, tankRecycleCursor);
+	skipv<TankComponent>(strm, tankCursor - 1, "FactoryStorage", "tankPool");
+	skipArray<int32_t>(strm, tankRecycleCursor);
 }
 
 DysonSphereParser::PowerGeneratorComponent::PowerGeneratorComponent() :
@@ -1230,38 +2334,19 @@ DysonSphereParser::PowerGeneratorComponent::PowerGeneratorComponent() :
 {
 }
 
-void DysonSphereParser::PowerGeneratorComponent::parse(std::ifstream& strm)
+void DysonSphereParser::PowerGeneratorComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PowerGeneratorComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, networkId);
-	read(strm, photovoltaic);
-	read(strm, wind);
-	read(strm, gamma);
-	read(strm, genEnergyPerTick);
-	read(strm, useFuelPerTick);
-	read(strm, fuelMask);
-	read(strm, fuelEnergy);
-	read(strm, curFuelId);
-	read(strm, fuelId);
-	read(strm, fuelCount);
-	read(strm, fuelHeat);
-	read(strm, catalystId);
-	read(strm, catalystPoint);
-	read(strm, productId);
-	read(strm, productCount);
-	read(strm, productHeat);
-	read(strm, warmup);
-	read(strm, ionEnhance);
-	read(strm, x);
-	read(strm, y);
-	read(strm, z);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::PowerGeneratorComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::PowerGeneratorComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::PowerNodeComponent::PowerNodeComponent() :
@@ -1278,24 +2363,19 @@ DysonSphereParser::PowerNodeComponent::PowerNodeComponent() :
 {
 }
 
-void DysonSphereParser::PowerNodeComponent::parse(std::ifstream& strm)
+void DysonSphereParser::PowerNodeComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PowerNodeComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, networkId);
-	read(strm, isCharger);
-	read(strm, workEnergyPerTick);
-	read(strm, idleEnergyPerTick);
-	read(strm, requiredEnergy);
-	powerPoint.parse(strm);
-	read(strm, connectDistance);
-	read(strm, coverRadius);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::PowerNodeComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::PowerNodeComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::PowerConsumerComponent::PowerConsumerComponent() :
@@ -1310,22 +2390,19 @@ DysonSphereParser::PowerConsumerComponent::PowerConsumerComponent() :
 {
 }
 
-void DysonSphereParser::PowerConsumerComponent::parse(std::ifstream& strm)
+void DysonSphereParser::PowerConsumerComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PowerConsumerComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, networkId);
-	plugPos.parse(strm);
-	read(strm, requiredEnergy);
-	read(strm, servedEnergy);
-	read(strm, workEnergyPerTick);
-	read(strm, idleEnergyPerTick);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::PowerConsumerComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::PowerConsumerComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::PowerAccumulatorComponent::PowerAccumulatorComponent() :
@@ -1340,21 +2417,19 @@ DysonSphereParser::PowerAccumulatorComponent::PowerAccumulatorComponent() :
 {
 }
 
-void DysonSphereParser::PowerAccumulatorComponent::parse(std::ifstream& strm)
+void DysonSphereParser::PowerAccumulatorComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PowerAccumulatorComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, networkId);
-	read(strm, inputEnergyPerTick);
-	read(strm, outputEnergyPerTick);
-	read(strm, curEnergy);
-	read(strm, maxEnergy);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::PowerAccumulatorComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::PowerAccumulatorComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::PowerExchangerComponent::PowerExchangerComponent() :
@@ -1386,38 +2461,19 @@ DysonSphereParser::PowerExchangerComponent::PowerExchangerComponent() :
 {
 }
 
-void DysonSphereParser::PowerExchangerComponent::parse(std::ifstream& strm)
+void DysonSphereParser::PowerExchangerComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 1)
-	{
-		assert(false);
-		throw std::exception("Unexpected PowerExchangerComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, networkId);
-	read(strm, emptyCount);
-	read(strm, fullCount);
-	read(strm, targetState);
-	read(strm, state);
-	read(strm, energyPerTick);
-	read(strm, curPoolEnergy);
-	read(strm, poolMaxEnergy);
-	read(strm, emptyId);
-	read(strm, fullId);
-	read(strm, belt0);
-	read(strm, belt1);
-	read(strm, belt2);
-	read(strm, belt3);
-	read(strm, isOutput0);
-	read(strm, isOutput1);
-	read(strm, isOutput2);
-	read(strm, isOutput3);
-	read(strm, outputSlot);
-	read(strm, inputSlot);
-	read(strm, outputRectify);
-	read(strm, inputRectify);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::PowerExchangerComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::PowerExchangerComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::PowerNetworkStructures_Node::PowerNetworkStructures_Node() :
@@ -1437,29 +2493,19 @@ DysonSphereParser::PowerNetworkStructures_Node::PowerNetworkStructures_Node() :
 {
 }
 
-void DysonSphereParser::PowerNetworkStructures_Node::parse(std::ifstream& strm)
+void DysonSphereParser::PowerNetworkStructures_Node::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PowerNetworkStructures_Node version");
-	}
-	read(strm, id);
-	read(strm, x);
-	read(strm, y);
-	read(strm, z);
-	read(strm, connDistance2);
-	read(strm, coverRadius2);
-	read(strm, genId);
-	read(strm, accId);
-	read(strm, excId);
-	read(strm, numConnIdsForLoad);
-	read(strm, numLineIdsForLoad);
-	read(strm, numConsumers);
-	read(strm, connIdsForLoad, numConnIdsForLoad);
-	read(strm, lineIdsForLoad, numLineIdsForLoad);
-	read(strm, consumers, numConsumers);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::PowerNetworkStructures_Node::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::PowerNetworkStructures_Node::skip(InputStream& strm)
+{
+	schemaSkip<PowerNetworkStructures_Node>(strm);
 }
 
 DysonSphereParser::PowerNetwork::PowerNetwork() :
@@ -1473,25 +2519,69 @@ DysonSphereParser::PowerNetwork::PowerNetwork() :
 {
 }
 
-void DysonSphereParser::PowerNetwork::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::PowerNetwork::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PowerNetwork version");
-	}
 	read(strm, id);
 	read(strm, numNodes);
 	read(strm, numConsumers);
 	read(strm, numGenerators);
 	read(strm, numAccumulators);
 	read(strm, numExchangers);
-	readv(strm, nodes, numNodes);
-	read(strm, consumers, numConsumers);
-	read(strm, generators, numGenerators);
-	read(strm, accumulators, numAccumulators);
-	read(strm, exchangers, numExchangers);
+	readv(strm, nodes, numNodes, "PowerNetwork", "nodes");
+	read(strm, consumers, numConsumers, "PowerNetwork", "consumers");
+	read(strm, generators, numGenerators, "PowerNetwork", "generators");
+	read(strm, accumulators, numAccumulators, "PowerNetwork", "accumulators");
+	read(strm, exchangers, numExchangers, "PowerNetwork", "exchangers");
+}
+
+void DysonSphereParser::PowerNetwork::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("PowerNetwork", "version");
+}
+
+template<>
+void DysonSphereParser::PowerNetwork::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, id);
+	write(strm, numNodes);
+	write(strm, numConsumers);
+	write(strm, numGenerators);
+	write(strm, numAccumulators);
+	write(strm, numExchangers);
+	writev(strm, nodes);
+	write(strm, consumers);
+	write(strm, generators);
+	write(strm, accumulators);
+	write(strm, exchangers);
+}
+
+void DysonSphereParser::PowerNetwork::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::PowerNetwork::skip(InputStream& strm)
+{
+	int32_t numNodes = 0;
+	int32_t numConsumers = 0;
+	int32_t numGenerators = 0;
+	int32_t numAccumulators = 0;
+	int32_t numExchangers = 0;
+	strm.skip(8);  // version, id
+	read(strm, numNodes);
+	read(strm, numConsumers);
+	read(strm, numGenerators);
+	read(strm, numAccumulators);
+	read(strm, numExchangers);
+	skipv<PowerNetworkStructures_Node>(strm, numNodes, "PowerNetwork", "nodes");
+	skipArray<int32_t>(strm, numConsumers);
+	skipArray<int32_t>(strm, numGenerators);
+	skipArray<int32_t>(strm, numAccumulators);
+	skipArray<int32_t>(strm, numExchangers);
 }
 
 DysonSphereParser::PowerSystem::PowerSystem() :
@@ -1518,42 +2608,39 @@ DysonSphereParser::PowerSystem::PowerSystem() :
 {
 }
 
-void DysonSphereParser::PowerSystem::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::PowerSystem::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PowerSystem version");
-	}
 	read(strm, generatorCapacity);
 	read(strm, genCursor);
 	read(strm, genRecycleCursor);
-	readv(strm, genPool, genCursor - 1);
-	read(strm, genRecycle, genRecycleCursor);
+	readv(strm, genPool, genCursor - 1, "PowerSystem", "genPool");
+	read(strm, genRecycle, genRecycleCursor, "PowerSystem", "genRecycle");
 	read(strm, nodeCapacity);
 	read(strm, nodeCursor);
 	read(strm, nodeRecycleCursor);
-	readv(strm, nodePool, nodeCursor - 1);
-	read(strm, nodeRecycle, nodeRecycleCursor);
+	readv(strm, nodePool, nodeCursor - 1, "PowerSystem", "nodePool");
+	read(strm, nodeRecycle, nodeRecycleCursor, "PowerSystem", "nodeRecycle");
 	read(strm, consumerCapacity);
 	read(strm, consumerCursor);
 	read(strm, consumerRecycleCursor);
-	readv(strm, consumerPool, consumerCursor - 1);
-	read(strm, consumerRecycle, consumerRecycleCursor);
+	readv(strm, consumerPool, consumerCursor - 1, "PowerSystem", "consumerPool");
+	read(strm, consumerRecycle, consumerRecycleCursor, "PowerSystem", "consumerRecycle");
 	read(strm, accumulatorCapacity);
 	read(strm, accCursor);
 	read(strm, accRecycleCursor);
-	readv(strm, accPool, accCursor - 1);
-	read(strm, accRecycle, accRecycleCursor);
+	readv(strm, accPool, accCursor - 1, "PowerSystem", "accPool");
+	read(strm, accRecycle, accRecycleCursor, "PowerSystem", "accRecycle");
 	read(strm, exchangerCapacity);
 	read(strm, excCursor);
 	read(strm, excRecycleCursor);
-	readv(strm, excPool, excCursor - 1);
-	read(strm, excRecycle, excRecycleCursor);
+	readv(strm, excPool, excCursor - 1, "PowerSystem", "excPool");
+	read(strm, excRecycle, excRecycleCursor, "PowerSystem", "excRecycle");
 	read(strm, networkCapacity);
 	read(strm, netCursor);
 	read(strm, netRecycleCursor);
+	if (!strm.checkCount(netCursor, sizeof(int32_t), "PowerSystem", "netPool"))
+		return;
 	powerNetworkIncludedFlag.resize(netCursor);
 	for (auto it = powerNetworkIncludedFlag.begin(); it != powerNetworkIncludedFlag.end(); ++it)
 	{
@@ -1564,7 +2651,108 @@ void DysonSphereParser::PowerSystem::parse(std::ifstream& strm)
 			netPool.rbegin()->parse(strm);
 		}
 	}
-	read(strm, netRecycle, netRecycleCursor);
+	read(strm, netRecycle, netRecycleCursor, "PowerSystem", "netRecycle");
+}
+
+void DysonSphereParser::PowerSystem::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("PowerSystem", "version");
+}
+
+template<>
+void DysonSphereParser::PowerSystem::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, generatorCapacity);
+	write(strm, genCursor);
+	write(strm, genRecycleCursor);
+	writev(strm, genPool);
+	write(strm, genRecycle);
+	write(strm, nodeCapacity);
+	write(strm, nodeCursor);
+	write(strm, nodeRecycleCursor);
+	writev(strm, nodePool);
+	write(strm, nodeRecycle);
+	write(strm, consumerCapacity);
+	write(strm, consumerCursor);
+	write(strm, consumerRecycleCursor);
+	writev(strm, consumerPool);
+	write(strm, consumerRecycle);
+	write(strm, accumulatorCapacity);
+	write(strm, accCursor);
+	write(strm, accRecycleCursor);
+	writev(strm, accPool);
+	write(strm, accRecycle);
+	write(strm, exchangerCapacity);
+	write(strm, excCursor);
+	write(strm, excRecycleCursor);
+	writev(strm, excPool);
+	write(strm, excRecycle);
+	write(strm, networkCapacity);
+	write(strm, netCursor);
+	write(strm, netRecycleCursor);
+	auto next = netPool.begin();
+	for (auto it = powerNetworkIncludedFlag.begin(); it != powerNetworkIncludedFlag.end(); ++it)
+	{
+		write(strm, *it);
+		if (*it && next != netPool.end())
+			(next++)->serialize(strm);
+	}
+	write(strm, netRecycle);
+}
+
+void DysonSphereParser::PowerSystem::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::PowerSystem::skip(InputStream& strm)
+{
+	int32_t version = 0;
+	int32_t capacity = 0;
+	int32_t cursor = 0;
+	int32_t recycleCursor = 0;
+	read(strm, version);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<PowerGeneratorComponent>(strm, cursor - 1, "PowerSystem", "genPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<PowerNodeComponent>(strm, cursor - 1, "PowerSystem", "nodePool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<PowerConsumerComponent>(strm, cursor - 1, "PowerSystem", "consumerPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<PowerAccumulatorComponent>(strm, cursor - 1, "PowerSystem", "accPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<PowerExchangerComponent>(strm, cursor - 1, "PowerSystem", "excPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	if (!strm.checkCount(cursor, sizeof(int32_t), "PowerSystem", "netPool"))
+		return;
+	for (int32_t i = 0; i < cursor && strm; ++i)
+	{
+		int32_t included = 0;
+		read(strm, included);
+		if (included)
+			PowerNetwork::skip(strm);
+	}
+	skipArray<int32_t>(strm, recycleCursor);
 }
 
 DysonSphereParser::MinerComponent::MinerComponent() :
@@ -1587,30 +2775,19 @@ DysonSphereParser::MinerComponent::MinerComponent() :
 {
 }
 
-void DysonSphereParser::MinerComponent::parse(std::ifstream& strm)
+void DysonSphereParser::MinerComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected MinerComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, pcId);
-	read<DysonSphereParser::MinerComponent::EMinerType, int32_t>(strm, type);
-	read(strm, speed);
-	read(strm, time);
-	read(strm, period);
-	read(strm, insertTarget);
-	read<DysonSphereParser::MinerComponent::EWorkState, int32_t>(strm, workstate);
-	read(strm, veinCount);
-	read(strm, veins, veinCount);
-	read(strm, currentVeinIndex);
-	read(strm, minimumVeinAmount);
-	read(strm, productId);
-	read(strm, productCount);
-	read(strm, seed);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::MinerComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::MinerComponent::skip(InputStream& strm)
+{
+	schemaSkip<MinerComponent>(strm);
 }
 
 DysonSphereParser::InserterComponent::InserterComponent() :
@@ -1638,40 +2815,23 @@ DysonSphereParser::InserterComponent::InserterComponent() :
 {
 }
 
-void DysonSphereParser::InserterComponent::parse(std::ifstream& strm)
+void DysonSphereParser::InserterComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected InserterComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, pcId);
-	read<DysonSphereParser::InserterComponent::EInserterStage, int32_t>(strm, stage);
-	read(strm, speed);
-	read(strm, time);
-	read(strm, stt);
-	read(strm, delay);
-	read(strm, pickTarget);
-	read(strm, insertTarget);
-	read(strm, careNeeds);
-	read(strm, canStack);
-	read(strm, pickOffset);
-	read(strm, insertOffset);
-	read(strm, filter);
-	read(strm, itemId);
-	read(strm, stackCount);
-	read(strm, stackSize);
-	pos2.parse(strm);
-	rot2.parse(strm);
-	read(strm, t1);
-	read(strm, t2);
+	schemaParse(strm, *this);
 }
 
-DysonSphereParser::AssemblerComponent::AssemblerComponent() :
-	version(0),
+void DysonSphereParser::InserterComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::InserterComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
+}
+
+DysonSphereParser::AssemblerComponent::AssemblerComponent() :
+	version(0),
 	id(0),
 	entityId(0),
 	pcId(0),
@@ -1692,14 +2852,9 @@ DysonSphereParser::AssemblerComponent::AssemblerComponent() :
 {
 }
 
-void DysonSphereParser::AssemblerComponent::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::AssemblerComponent::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected AssemblerComponent version");
-	}
 	read(strm, id);
 	read(strm, entityId);
 	read(strm, pcId);
@@ -1713,19 +2868,81 @@ void DysonSphereParser::AssemblerComponent::parse(std::ifstream& strm)
 		read<DysonSphereParser::AssemblerComponent::ERecipeType, int32_t>(strm, recipeType);
 		read(strm, timeSpend);
 		read(strm, numRequires);
-		read(strm, requires, numRequires);
+		read(strm, requires, numRequires, "AssemblerComponent", "requires");
 		read(strm, numRequireCounts);
-		read(strm, requireCounts, numRequireCounts);
+		read(strm, requireCounts, numRequireCounts, "AssemblerComponent", "requireCounts");
 		read(strm, numServed);
-		read(strm, served, numServed);
+		read(strm, served, numServed, "AssemblerComponent", "served");
 		read(strm, numNeeds);
-		read(strm, needs, numNeeds);
+		read(strm, needs, numNeeds, "AssemblerComponent", "needs");
 		read(strm, numProducts);
-		read(strm, products, numProducts);
+		read(strm, products, numProducts, "AssemblerComponent", "products");
 		read(strm, numProductCounts);
-		read(strm, productCounts, numProductCounts);
+		read(strm, productCounts, numProductCounts, "AssemblerComponent", "productCounts");
 		read(strm, numProduced);
-		read(strm, produced, numProduced);
+		read(strm, produced, numProduced, "AssemblerComponent", "produced");
+	}
+}
+
+void DysonSphereParser::AssemblerComponent::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("AssemblerComponent", "version");
+}
+
+template<>
+void DysonSphereParser::AssemblerComponent::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, id);
+	write(strm, entityId);
+	write(strm, pcId);
+	write(strm, replicating);
+	write(strm, outputing);
+	write(strm, speed);
+	write(strm, time);
+	write(strm, recipeId);
+	if (recipeId > 0)
+	{
+		write<DysonSphereParser::AssemblerComponent::ERecipeType, int32_t>(strm, recipeType);
+		write(strm, timeSpend);
+		write(strm, numRequires);
+		write(strm, requires);
+		write(strm, numRequireCounts);
+		write(strm, requireCounts);
+		write(strm, numServed);
+		write(strm, served);
+		write(strm, numNeeds);
+		write(strm, needs);
+		write(strm, numProducts);
+		write(strm, products);
+		write(strm, numProductCounts);
+		write(strm, productCounts);
+		write(strm, numProduced);
+		write(strm, produced);
+	}
+}
+
+void DysonSphereParser::AssemblerComponent::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::AssemblerComponent::skip(InputStream& strm)
+{
+	int32_t recipeId = 0;
+	strm.skip(26);  // version, id, entityId, pcId, replicating, outputing, speed, time
+	read(strm, recipeId);
+	if (recipeId > 0)
+	{
+		strm.skip(8);  // recipeType, timeSpend
+		for (int32_t i = 0; i < 7; ++i)
+		{
+			int32_t count = 0;
+			read(strm, count);
+			skipArray<int32_t>(strm, count);
+		}
 	}
 }
 
@@ -1757,37 +2974,19 @@ DysonSphereParser::FractionateComponent::FractionateComponent() :
 {
 }
 
-void DysonSphereParser::FractionateComponent::parse(std::ifstream& strm)
+void DysonSphereParser::FractionateComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected FractionateComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, pcId);
-	read(strm, belt0);
-	read(strm, belt1);
-	read(strm, belt2);
-	read(strm, isOutput0);
-	read(strm, isOutput1);
-	read(strm, isOutput2);
-	read(strm, isWorking);
-	read(strm, produceProb);
-	read(strm, need);
-	read(strm, product);
-	read(strm, needCurrCount);
-	read(strm, productCurrCount);
-	read(strm, oriProductCurrCount);
-	read(strm, progress);
-	read(strm, isRand);
-	read(strm, fractionateSuccess);
-	read(strm, needMaxCount);
-	read(strm, productMaxCount);
-	read(strm, oriProductMaxCount);
-	read(strm, seed);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::FractionateComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::FractionateComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::EjectorComponent::EjectorComponent() :
@@ -1810,32 +3009,19 @@ DysonSphereParser::EjectorComponent::EjectorComponent() :
 {
 }
 
-void DysonSphereParser::EjectorComponent::parse(std::ifstream& strm)
+void DysonSphereParser::EjectorComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected EjectorComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, planetId);
-	read(strm, pcId);
-	read(strm, direction);
-	read(strm, time);
-	read(strm, fired);
-	read(strm, chargeSpend);
-	read(strm, coldSpend);
-	read(strm, bulletId);
-	read(strm, bulletCount);
-	read(strm, orbitId);
-	read(strm, pivotY);
-	read(strm, muzzleY);
-	localPosN.parse(strm);
-	read(strm, localAlt);
-	localRot.parse(strm);
-	localDir.parse(strm);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::EjectorComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::EjectorComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::SiloComponent::SiloComponent() :
@@ -1856,29 +3042,19 @@ DysonSphereParser::SiloComponent::SiloComponent() :
 {
 }
 
-void DysonSphereParser::SiloComponent::parse(std::ifstream& strm)
+void DysonSphereParser::SiloComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected SiloComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, planetId);
-	read(strm, pcId);
-	read(strm, direction);
-	read(strm, time);
-	read(strm, fired);
-	read(strm, chargeSpend);
-	read(strm, coldSpend);
-	read(strm, bulletId);
-	read(strm, bulletCount);
-	read(strm, autoIndex);
-	read(strm, hasNode);
-	localPos.parse(strm);
-	localRot.parse(strm);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::SiloComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::SiloComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::LabComponent::LabComponent() :
@@ -1907,14 +3083,9 @@ DysonSphereParser::LabComponent::LabComponent() :
 {
 }
 
-void DysonSphereParser::LabComponent::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::LabComponent::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected LabComponent version");
-	}
 	read(strm, id);
 	read(strm, entityId);
 	read(strm, pcId);
@@ -1929,29 +3100,111 @@ void DysonSphereParser::LabComponent::parse(std::ifstream& strm)
 	if (researchMode)
 	{
 		read(strm, numMatrixPoints);
-		read(strm, matrixPoints, numMatrixPoints);
+		read(strm, matrixPoints, numMatrixPoints, "LabComponent", "matrixPoints");
 		read(strm, numMatrixServed);
-		read(strm, matrixServed, numMatrixServed);
+		read(strm, matrixServed, numMatrixServed, "LabComponent", "matrixServed");
 		read(strm, numNeeds);
-		read(strm, needs, numNeeds);
+		read(strm, needs, numNeeds, "LabComponent", "needs");
 	}
 	else if (recipeId > 0)
 	{
 		read(strm, timeSpend);
 		read(strm, numRequires);
-		read(strm, requires, numRequires);
+		read(strm, requires, numRequires, "LabComponent", "requires");
 		read(strm, numRequireCounts);
-		read(strm, requireCounts, numRequireCounts);
+		read(strm, requireCounts, numRequireCounts, "LabComponent", "requireCounts");
 		read(strm, numServed);
-		read(strm, served, numServed);
+		read(strm, served, numServed, "LabComponent", "served");
 		read(strm, numNeeds);
-		read(strm, needs, numNeeds);
+		read(strm, needs, numNeeds, "LabComponent", "needs");
 		read(strm, numProducts);
-		read(strm, products, numProducts);
+		read(strm, products, numProducts, "LabComponent", "products");
 		read(strm, numProductCounts);
-		read(strm, productCounts, numProductCounts);
+		read(strm, productCounts, numProductCounts, "LabComponent", "productCounts");
 		read(strm, numProduced);
-		read(strm, produced, numProduced);
+		read(strm, produced, numProduced, "LabComponent", "produced");
+	}
+}
+
+void DysonSphereParser::LabComponent::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("LabComponent", "version");
+}
+
+template<>
+void DysonSphereParser::LabComponent::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, id);
+	write(strm, entityId);
+	write(strm, pcId);
+	write(strm, nextLabId);
+	write(strm, replicating);
+	write(strm, outputing);
+	write(strm, time);
+	write(strm, hashBytes);
+	write(strm, researchMode);
+	write(strm, recipeId);
+	write(strm, techId);
+	if (researchMode)
+	{
+		write(strm, numMatrixPoints);
+		write(strm, matrixPoints);
+		write(strm, numMatrixServed);
+		write(strm, matrixServed);
+		write(strm, numNeeds);
+		write(strm, needs);
+	}
+	else if (recipeId > 0)
+	{
+		write(strm, timeSpend);
+		write(strm, numRequires);
+		write(strm, requires);
+		write(strm, numRequireCounts);
+		write(strm, requireCounts);
+		write(strm, numServed);
+		write(strm, served);
+		write(strm, numNeeds);
+		write(strm, needs);
+		write(strm, numProducts);
+		write(strm, products);
+		write(strm, numProductCounts);
+		write(strm, productCounts);
+		write(strm, numProduced);
+		write(strm, produced);
+	}
+}
+
+void DysonSphereParser::LabComponent::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::LabComponent::skip(InputStream& strm)
+{
+	bool researchMode = false;
+	int32_t recipeId = 0;
+	strm.skip(30);  // version, id, entityId, pcId, nextLabId, replicating, outputing, time, hashBytes
+	read(strm, researchMode);
+	read(strm, recipeId);
+	strm.skip(4);  // techId
+	int32_t arrayCount = 0;
+	if (researchMode)
+	{
+		arrayCount = 3;
+	}
+	else if (recipeId > 0)
+	{
+		strm.skip(4);  // timeSpend
+		arrayCount = 7;
+	}
+	for (int32_t i = 0; i < arrayCount; ++i)
+	{
+		int32_t count = 0;
+		read(strm, count);
+		skipArray<int32_t>(strm, count);
 	}
 }
 
@@ -1981,49 +3234,141 @@ DysonSphereParser::FactorySystem::FactorySystem() :
 {
 }
 
-void DysonSphereParser::FactorySystem::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::FactorySystem::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected FactorySystem version");
-	}
 	read(strm, minerCapacity);
 	read(strm, minerCursor);
 	read(strm, minerRecycleCursor);
-	readv(strm, minerPool, minerCursor - 1);
-	read(strm, minerRecycle, minerRecycleCursor);
+	readv(strm, minerPool, minerCursor - 1, "FactorySystem", "minerPool");
+	read(strm, minerRecycle, minerRecycleCursor, "FactorySystem", "minerRecycle");
 	read(strm, inserterCapacity);
 	read(strm, inserterCursor);
 	read(strm, inserterRecycleCursor);
-	readv(strm, inserterPool, inserterCursor - 1);
-	read(strm, inserterRecycle, inserterRecycleCursor);
+	readv(strm, inserterPool, inserterCursor - 1, "FactorySystem", "inserterPool");
+	read(strm, inserterRecycle, inserterRecycleCursor, "FactorySystem", "inserterRecycle");
 	read(strm, assemblerCapacity);
 	read(strm, assemblerCursor);
 	read(strm, assemblerRecycleCursor);
-	readv(strm, assemblerPool, assemblerCursor - 1);
-	read(strm, assemblerRecycle, assemblerRecycleCursor);
+	readv(strm, assemblerPool, assemblerCursor - 1, "FactorySystem", "assemblerPool");
+	read(strm, assemblerRecycle, assemblerRecycleCursor, "FactorySystem", "assemblerRecycle");
 	read(strm, fractionateCapacity);
 	read(strm, fractionateCursor);
 	read(strm, fractionateRecycleCursor);
-	readv(strm, fractionatePool, fractionateCursor - 1);
-	read(strm, fractionateRecycle, fractionateRecycleCursor);
+	readv(strm, fractionatePool, fractionateCursor - 1, "FactorySystem", "fractionatePool");
+	read(strm, fractionateRecycle, fractionateRecycleCursor, "FactorySystem", "fractionateRecycle");
 	read(strm, ejectorCapacity);
 	read(strm, ejectorCursor);
 	read(strm, ejectorRecycleCursor);
-	readv(strm, ejectorPool, ejectorCursor - 1);
-	read(strm, ejectorRecycle, ejectorRecycleCursor);
+	readv(strm, ejectorPool, ejectorCursor - 1, "FactorySystem", "ejectorPool");
+	read(strm, ejectorRecycle, ejectorRecycleCursor, "FactorySystem", "ejectorRecycle");
 	read(strm, siloCapacity);
 	read(strm, siloCursor);
 	read(strm, siloRecycleCursor);
-	readv(strm, siloPool, siloCursor - 1);
-	read(strm, siloRecycle, siloRecycleCursor);
+	readv(strm, siloPool, siloCursor - 1, "FactorySystem", "siloPool");
+	read(strm, siloRecycle, siloRecycleCursor, "FactorySystem", "siloRecycle");
 	read(strm, labCapacity);
 	read(strm, labCursor);
 	read(strm, labRecycleCursor);
-	readv(strm, labPool, labCursor - 1);
-	read(strm, labRecycle, labRecycleCursor);
+	readv(strm, labPool, labCursor - 1, "FactorySystem", "labPool");
+	read(strm, labRecycle, labRecycleCursor, "FactorySystem", "labRecycle");
+}
+
+void DysonSphereParser::FactorySystem::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("FactorySystem", "version");
+}
+
+template<>
+void DysonSphereParser::FactorySystem::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, minerCapacity);
+	write(strm, minerCursor);
+	write(strm, minerRecycleCursor);
+	writev(strm, minerPool);
+	write(strm, minerRecycle);
+	write(strm, inserterCapacity);
+	write(strm, inserterCursor);
+	write(strm, inserterRecycleCursor);
+	writev(strm, inserterPool);
+	write(strm, inserterRecycle);
+	write(strm, assemblerCapacity);
+	write(strm, assemblerCursor);
+	write(strm, assemblerRecycleCursor);
+	writev(strm, assemblerPool);
+	write(strm, assemblerRecycle);
+	write(strm, fractionateCapacity);
+	write(strm, fractionateCursor);
+	write(strm, fractionateRecycleCursor);
+	writev(strm, fractionatePool);
+	write(strm, fractionateRecycle);
+	write(strm, ejectorCapacity);
+	write(strm, ejectorCursor);
+	write(strm, ejectorRecycleCursor);
+	writev(strm, ejectorPool);
+	write(strm, ejectorRecycle);
+	write(strm, siloCapacity);
+	write(strm, siloCursor);
+	write(strm, siloRecycleCursor);
+	writev(strm, siloPool);
+	write(strm, siloRecycle);
+	write(strm, labCapacity);
+	write(strm, labCursor);
+	write(strm, labRecycleCursor);
+	writev(strm, labPool);
+	write(strm, labRecycle);
+}
+
+void DysonSphereParser::FactorySystem::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::FactorySystem::skip(InputStream& strm)
+{
+	int32_t version = 0;
+	int32_t capacity = 0;
+	int32_t cursor = 0;
+	int32_t recycleCursor = 0;
+	read(strm, version);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<MinerComponent>(strm, cursor - 1, "FactorySystem", "minerPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<InserterComponent>(strm, cursor - 1, "FactorySystem", "inserterPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<AssemblerComponent>(strm, cursor - 1, "FactorySystem", "assemblerPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<FractionateComponent>(strm, cursor - 1, "FactorySystem", "fractionatePool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<EjectorComponent>(strm, cursor - 1, "FactorySystem", "ejectorPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<SiloComponent>(strm, cursor - 1, "FactorySystem", "siloPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<LabComponent>(strm, cursor - 1, "FactorySystem", "labPool");
+	skipArray<int32_t>(strm, recycleCursor);
 }
 
 DysonSphereParser::DroneData::DroneData() :
@@ -2038,23 +3383,19 @@ DysonSphereParser::DroneData::DroneData() :
 {
 }
 
-void DysonSphereParser::DroneData::parse(std::ifstream& strm)
+void DysonSphereParser::DroneData::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected DroneData version");
-	}
-	begin.parse(strm);
-	end.parse(strm);
-	read(strm, endId);
-	read(strm, direction);
-	read(strm, maxt);
-	read(strm, t);
-	read(strm, itemId);
-	read(strm, itemCount);
-	read(strm, gene);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::DroneData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::DroneData::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::LocalLogisticOrder::LocalLogisticOrder() :
@@ -2068,20 +3409,19 @@ DysonSphereParser::LocalLogisticOrder::LocalLogisticOrder() :
 {
 }
 
-void DysonSphereParser::LocalLogisticOrder::parse(std::ifstream& strm)
+void DysonSphereParser::LocalLogisticOrder::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected LocalLogisticOrder version");
-	}
-	read(strm, otherStationId);
-	read(strm, thisIndex);
-	read(strm, otherIndex);
-	read(strm, itemId);
-	read(strm, thisOrdered);
-	read(strm, otherOrdered);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::LocalLogisticOrder::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::LocalLogisticOrder::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::ShipData::ShipData() :
@@ -2103,34 +3443,19 @@ DysonSphereParser::ShipData::ShipData() :
 {
 }
 
-void DysonSphereParser::ShipData::parse(std::ifstream& strm)
+void DysonSphereParser::ShipData::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected ShipData version");
-	}
-	read(strm, stage);
-	read(strm, planetA);
-	read(strm, planetB);
-	uPos.parse(strm);
-	uVel.parse(strm);
-	read(strm, uSpeed);
-	read(strm, warpState);
-	uRot.parse(strm);
-	uAngularVel.parse(strm);
-	read(strm, uAngularSpeed);
-	pPosTemp.parse(strm);
-	pRotTemp.parse(strm);
-	read(strm, otherGId);
-	read(strm, direction);
-	read(strm, t);
-	read(strm, itemId);
-	read(strm, itemCount);
-	read(strm, gene);
-	read(strm, shipIndex);
-	read(strm, warperCnt);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::ShipData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::ShipData::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::RemoteLogisticOrder::RemoteLogisticOrder() :
@@ -2144,20 +3469,19 @@ DysonSphereParser::RemoteLogisticOrder::RemoteLogisticOrder() :
 {
 }
 
-void DysonSphereParser::RemoteLogisticOrder::parse(std::ifstream& strm)
+void DysonSphereParser::RemoteLogisticOrder::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected RemoteLogisticOrder version");
-	}
-	read(strm, otherStationGId);
-	read(strm, thisIndex);
-	read(strm, otherIndex);
-	read(strm, itemId);
-	read(strm, thisOrdered);
-	read(strm, otherOrdered);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::RemoteLogisticOrder::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::RemoteLogisticOrder::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::StationStore::StationStore() :
@@ -2172,21 +3496,19 @@ DysonSphereParser::StationStore::StationStore() :
 {
 }
 
-void DysonSphereParser::StationStore::parse(std::ifstream& strm)
+void DysonSphereParser::StationStore::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected StationStore version");
-	}
-	read(strm, itemId);
-	read(strm, count);
-	read(strm, localOrder);
-	read(strm, remoteOrder);
-	read(strm, max);
-	read<DysonSphereParser::StationStore::ELogisticStorage, int32_t>(strm, localLogic);
-	read<DysonSphereParser::StationStore::ELogisticStorage, int32_t>(strm, remoteLogic);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::StationStore::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::StationStore::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::SlotData::SlotData() :
@@ -2197,12 +3519,19 @@ DysonSphereParser::SlotData::SlotData() :
 {
 }
 
-void DysonSphereParser::SlotData::parse(std::ifstream& strm)
+void DysonSphereParser::SlotData::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::SlotData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::SlotData::skip(InputStream& strm)
 {
-	read(strm, dir);
-	read(strm, beltId);
-	read(strm, storageIdx);
-	read(strm, counter);
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::StationComponent::StationComponent() :
@@ -2248,14 +3577,9 @@ DysonSphereParser::StationComponent::StationComponent() :
 {
 }
 
-void DysonSphereParser::StationComponent::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::StationComponent::parseVersion<2>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 2)
-	{
-		assert(false);
-		throw std::exception("Unexpected StationComponent version");
-	}
 	read(strm, id);
 	read(strm, gid);
 	read(strm, entityId);
@@ -2272,6 +3596,10 @@ void DysonSphereParser::StationComponent::parse(std::ifstream& strm)
 	{
 		read(strm, name);
 	}
+	else
+	{
+		name.clear();  // The record may be a reused ParseVisitor scratch.
+	}
 	read(strm, energy);
 	read(strm, energyPerTick);
 	read(strm, energyMax);
@@ -2280,29 +3608,29 @@ void DysonSphereParser::StationComponent::parse(std::ifstream& strm)
 	read(strm, idleDroneCount);
 	read(strm, workDroneCount);
 	read(strm, workDroneArraySize);
-	readv(strm, workDroneDatas, workDroneCount);
-	readv(strm, workDroneOrders, workDroneCount);
+	readv(strm, workDroneDatas, workDroneCount, "StationComponent", "workDroneDatas");
+	readv(strm, workDroneOrders, workDroneCount, "StationComponent", "workDroneOrders");
 	read(strm, idleShipCount);
 	read(strm, workShipCount);
 	read(strm, idleShipIndices);
 	read(strm, workShipIndices);
 	read(strm, arraySize);
-	readv(strm, workShipDatas, workShipCount);
-	readv(strm, workShipOrders, workShipCount);
+	readv(strm, workShipDatas, workShipCount, "StationComponent", "workShipDatas");
+	readv(strm, workShipOrders, workShipCount, "StationComponent", "workShipOrders");
 	read(strm, numStorage);
-	readv(strm, storage, numStorage);
+	readv(strm, storage, numStorage, "StationComponent", "storage");
 	read(strm, numSlots);
-	readv(strm, slots, numSlots);
+	readv(strm, slots, numSlots, "StationComponent", "slots");
 	read(strm, localPairProcess);
 	read(strm, remotePairProcess);
 	read(strm, nextShipIndex);
 	read(strm, isCollector);
 	read(strm, numCollectionIds);
-	read(strm, collectionIds, numCollectionIds);
+	read(strm, collectionIds, numCollectionIds, "StationComponent", "collectionIds");
 	read(strm, numCollectionPerTick);
-	read(strm, collectionPerTick, numCollectionPerTick);
+	read(strm, collectionPerTick, numCollectionPerTick, "StationComponent", "collectionPerTick");
 	read(strm, numCurrentCollections);
-	read(strm, currentCollections, numCurrentCollections);
+	read(strm, currentCollections, numCurrentCollections, "StationComponent", "currentCollections");
 	read(strm, collectSpeed);
 	read(strm, tripRangeDrones);
 	read(strm, tripRangeShips);
@@ -2313,6 +3641,116 @@ void DysonSphereParser::StationComponent::parse(std::ifstream& strm)
 	read(strm, deliveryShips);
 }
 
+void DysonSphereParser::StationComponent::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("StationComponent", "version");
+}
+
+template<>
+void DysonSphereParser::StationComponent::serializeVersion<2>(OutputStream& strm) const
+{
+	write(strm, id);
+	write(strm, gid);
+	write(strm, entityId);
+	write(strm, planetId);
+	write(strm, pcId);
+	write(strm, gene);
+	droneDock.serialize(strm);
+	shipDockPos.serialize(strm);
+	shipDockRot.serialize(strm);
+	write(strm, isStellar);
+	write(strm, nameIsIncludedFlag);
+	if (nameIsIncludedFlag > 0)
+		write(strm, name);
+	write(strm, energy);
+	write(strm, energyPerTick);
+	write(strm, energyMax);
+	write(strm, warperCount);
+	write(strm, warperMaxCount);
+	write(strm, idleDroneCount);
+	write(strm, workDroneCount);
+	write(strm, workDroneArraySize);
+	writev(strm, workDroneDatas);
+	writev(strm, workDroneOrders);
+	write(strm, idleShipCount);
+	write(strm, workShipCount);
+	write(strm, idleShipIndices);
+	write(strm, workShipIndices);
+	write(strm, arraySize);
+	writev(strm, workShipDatas);
+	writev(strm, workShipOrders);
+	write(strm, numStorage);
+	writev(strm, storage);
+	write(strm, numSlots);
+	writev(strm, slots);
+	write(strm, localPairProcess);
+	write(strm, remotePairProcess);
+	write(strm, nextShipIndex);
+	write(strm, isCollector);
+	write(strm, numCollectionIds);
+	write(strm, collectionIds);
+	write(strm, numCollectionPerTick);
+	write(strm, collectionPerTick);
+	write(strm, numCurrentCollections);
+	write(strm, currentCollections);
+	write(strm, collectSpeed);
+	write(strm, tripRangeDrones);
+	write(strm, tripRangeShips);
+	write(strm, includeOrbitCollector);
+	write(strm, warpEnableDist);
+	write(strm, warperNecessary);
+	write(strm, deliveryDrones);
+	write(strm, deliveryShips);
+}
+
+void DysonSphereParser::StationComponent::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::StationComponent::skip(InputStream& strm)
+{
+	int32_t nameIsIncludedFlag = 0;
+	strm.skip(69);  // version, id, gid, entityId, planetId, pcId, gene, droneDock, shipDockPos, shipDockRot, isStellar
+	read(strm, nameIsIncludedFlag);
+	if (nameIsIncludedFlag > 0)
+	{
+		uint8_t length = 0;
+		read(strm, length);
+		strm.skip(length);
+	}
+	strm.skip(36);  // energy, energyPerTick, energyMax, warperCount, warperMaxCount, idleDroneCount
+	int32_t workDroneCount = 0;
+	read(strm, workDroneCount);
+	strm.skip(4);  // workDroneArraySize
+	skipv<DroneData>(strm, workDroneCount, "StationComponent", "workDroneDatas");
+	skipv<LocalLogisticOrder>(strm, workDroneCount, "StationComponent", "workDroneOrders");
+	int32_t workShipCount = 0;
+	strm.skip(4);  // idleShipCount
+	read(strm, workShipCount);
+	strm.skip(20);  // idleShipIndices, workShipIndices, arraySize
+	skipv<ShipData>(strm, workShipCount, "StationComponent", "workShipDatas");
+	skipv<RemoteLogisticOrder>(strm, workShipCount, "StationComponent", "workShipOrders");
+	int32_t numStorage = 0;
+	read(strm, numStorage);
+	skipv<StationStore>(strm, numStorage, "StationComponent", "storage");
+	int32_t numSlots = 0;
+	read(strm, numSlots);
+	skipv<SlotData>(strm, numSlots, "StationComponent", "slots");
+	strm.skip(13);  // localPairProcess, remotePairProcess, nextShipIndex, isCollector
+	int32_t count = 0;
+	read(strm, count);
+	skipArray<int32_t>(strm, count);
+	read(strm, count);
+	skipArray<float>(strm, count);
+	read(strm, count);
+	skipArray<float>(strm, count);
+	strm.skip(38);  // collectSpeed, tripRangeDrones, tripRangeShips, includeOrbitCollector, warpEnableDist, warperNecessary, deliveryDrones, deliveryShips
+}
+
 DysonSphereParser::PlanetTransport::PlanetTransport() :
 	version(0),
 	stationCursor(0),
@@ -2321,19 +3759,51 @@ DysonSphereParser::PlanetTransport::PlanetTransport() :
 {
 }
 
-void DysonSphereParser::PlanetTransport::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::PlanetTransport::parseVersion<0>(InputStream& strm)
+{
+	read(strm, stationCursor);
+	read(strm, stationCapacity);
+	read(strm, stationRecycleCursor);
+	visiti(strm, stationIndex, stationPool, stationCursor - 1, &ParseVisitor::onStation, "PlanetTransport", "stationPool");
+	read(strm, stationRecycle, stationRecycleCursor, "PlanetTransport", "stationRecycle");
+}
+
+void DysonSphereParser::PlanetTransport::parse(InputStream& strm)
 {
 	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PlanetTransport version");
-	}
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("PlanetTransport", "version");
+}
+
+template<>
+void DysonSphereParser::PlanetTransport::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, stationCursor);
+	write(strm, stationCapacity);
+	write(strm, stationRecycleCursor);
+	writei(strm, stationIndex, stationPool, stationCursor - 1);
+	write(strm, stationRecycle);
+}
+
+void DysonSphereParser::PlanetTransport::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::PlanetTransport::skip(InputStream& strm)
+{
+	int32_t version = 0;
+	int32_t stationCursor = 0;
+	int32_t stationCapacity = 0;
+	int32_t stationRecycleCursor = 0;
+	read(strm, version);
 	read(strm, stationCursor);
 	read(strm, stationCapacity);
 	read(strm, stationRecycleCursor);
-	readi(strm, stationIndex, stationPool, stationCursor - 1);
-	read(strm, stationRecycle, stationRecycleCursor);
+	skipi<StationComponent>(strm, stationCursor - 1, "PlanetTransport", "stationPool");
+	skipArray<int32_t>(strm, stationRecycleCursor);
 }
 
 DysonSphereParser::MonsterComponent::MonsterComponent() :
@@ -2350,26 +3820,19 @@ DysonSphereParser::MonsterComponent::MonsterComponent() :
 {
 }
 
-void DysonSphereParser::MonsterComponent::parse(std::ifstream& strm)
+void DysonSphereParser::MonsterComponent::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected MonsterComponent version");
-	}
-	read(strm, id);
-	read(strm, entityId);
-	read(strm, walkSpeed);
-	point0.parse(strm);
-	point1.parse(strm);
-	point2.parse(strm);
-	read(strm, direction);
-	read(strm, stopTime);
-	read(strm, t);
-	read(strm, stopCurrentTime);
-	read<DysonSphereParser::MonsterComponent::EMonsterState, int32_t>(strm, monsterState);
-	read(strm, stepDistance);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::MonsterComponent::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::MonsterComponent::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::MonsterSystem::MonsterSystem() :
@@ -2380,440 +3843,1641 @@ DysonSphereParser::MonsterSystem::MonsterSystem() :
 {
 }
 
-void DysonSphereParser::MonsterSystem::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::MonsterSystem::parseVersion<0>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected MonsterSystem version");
-	}
 	read(strm, monsterCapacity);
 	read(strm, monsterCursor);
 	read(strm, monsterRecycleCursor);
-	readv(strm, monsterPool, monsterCursor - 1);
-	read(strm, monsterRecycle, monsterRecycleCursor);
+	readv(strm, monsterPool, monsterCursor - 1, "MonsterSystem", "monsterPool");
+	read(strm, monsterRecycle, monsterRecycleCursor, "MonsterSystem", "monsterRecycle");
 }
 
-DysonSphereParser::PlatformSystem::PlatformSystem() :
-	version(0),
-	reformDataByteCount(0),
-	reformOffsetsByteCount(0)
+void DysonSphereParser::MonsterSystem::parse(InputStream& strm)
 {
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("MonsterSystem", "version");
 }
 
-void DysonSphereParser::PlatformSystem::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::MonsterSystem::serializeVersion<0>(OutputStream& strm) const
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected PlatformSystem version");
-	}
-	read(strm, reformDataByteCount);
-	read(strm, reformData, reformDataByteCount);
-	read(strm, reformOffsetsByteCount);
-	read(strm, reformOffsets, reformOffsetsByteCount);
+	write(strm, monsterCapacity);
+	write(strm, monsterCursor);
+	write(strm, monsterRecycleCursor);
+	writev(strm, monsterPool);
+	write(strm, monsterRecycle);
 }
 
-DysonSphereParser::PlanetFactory::PlanetFactory() :
-	version(0),
-	planetId(0),
-	entityCapacity(0),
-	entityCursor(0),
-	entityRecycleCursor(0),
-	prebuildCapacity(0),
-	prebuildCursor(0),
-	prebuildRecycleCursor(0),
-	vegeCapacity(0),
-	vegeCursor(0),
-	vegeRecycleCursor(0),
-	veinCapacity(0),
-	veinCursor(0),
-	veinRecycleCursor(0)
+void DysonSphereParser::MonsterSystem::serialize(OutputStream& strm) const
 {
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
 }
 
-void DysonSphereParser::PlanetFactory::parse(std::ifstream& strm)
+void DysonSphereParser::MonsterSystem::skip(InputStream& strm)
 {
+	int32_t version = 0;
+	int32_t monsterCapacity = 0;
+	int32_t monsterCursor = 0;
+	int32_t monsterRecycleCursor = 0;
 	read(strm, version);
-	if (version != 1)
-	{
-		assert(false);
-		throw std::exception("Unexpected PlanetFactory version");
-	}
-	read(strm, planetId);
-	planet.parse(strm);
-	read(strm, entityCapacity);
-	read(strm, entityCursor);
-	read(strm, entityRecycleCursor);
-	readv(strm, entityPool, entityCursor - 1);
-	readv(strm, entityAnimPool, entityCursor - 1);
-	readv(strm, entitySignPool, entityCursor - 1);
-	read(strm, entityConnPool, entityCursor * 16 - 16);
-	read(strm, entityRecycle, entityRecycleCursor);
-	read(strm, prebuildCapacity);
-	read(strm, prebuildCursor);
-	read(strm, prebuildRecycleCursor);
-	readv(strm, prebuildPool, prebuildCursor - 1);
-	read(strm, prebuildConnPool, prebuildCursor * 16 - 16);
-	read(strm, prebuildRecycle, prebuildRecycleCursor);
-	read(strm, vegeCapacity);
-	read(strm, vegeCursor);
-	read(strm, vegeRecycleCursor);
-	readv(strm, vegePool, vegeCursor - 1);
-	read(strm, vegeRecycle, vegeRecycleCursor);
-	read(strm, veinCapacity);
-	read(strm, veinCursor);
-	read(strm, veinRecycleCursor);
-	readv(strm, veinPool, veinCursor - 1);
-	read(strm, veinRecycle, veinRecycleCursor);
-	readv(strm, veinAnimPool, veinCursor - 1);
-	cargoContainer.parse(strm);
-	cargoTraffic.parse(strm);
-	factoryStorage.parse(strm);
-	powerSystem.parse(strm);
-	factorySystem.parse(strm);
-	transport.parse(strm);
-	monsterSystem.parse(strm);
-	platformSystem.parse(strm);
+	read(strm, monsterCapacity);
+	read(strm, monsterCursor);
+	read(strm, monsterRecycleCursor);
+	skipv<MonsterComponent>(strm, monsterCursor - 1, "MonsterSystem", "monsterPool");
+	skipArray<int32_t>(strm, monsterRecycleCursor);
 }
 
-DysonSphereParser::DysonSail::DysonSail() :
-	st(0.0),
-	gs(0.0)
+DysonSphereParser::PlatformSystem::PlatformSystem() :
+	version(0),
+	reformDataByteCount(0),
+	reformOffsetsByteCount(0)
 {
 }
 
-void DysonSphereParser::DysonSail::parse(std::ifstream& strm)
+void DysonSphereParser::PlatformSystem::parse(InputStream& strm)
 {
-	read(strm, st);
-	p.parse(strm);
-	v.parse(strm);
-	read(strm, gs);
+	schemaParse(strm, *this);
 }
 
-DysonSphereParser::DysonSailInfo::DysonSailInfo() :
-	orbit(0),
-	node(0),
-	kill(0)
+void DysonSphereParser::PlatformSystem::serialize(OutputStream& strm) const
 {
+	schemaWrite(strm, *this);
 }
 
-void DysonSphereParser::DysonSailInfo::parse(std::ifstream& strm)
+void DysonSphereParser::PlatformSystem::skip(InputStream& strm)
 {
-	read(strm, orbit);
-	read(strm, node);
-	read(strm, kill);
-	posr.parse(strm);
+	schemaSkip<PlatformSystem>(strm);
 }
 
-DysonSphereParser::SailOrbit::SailOrbit() :
-	version(0),
-	id(0),
-	radius(0.0),
-	count(0),
-	enabled(false)
+DysonSphereParser::EntityIndex::EntityIndex()
 {
 }
 
-void DysonSphereParser::SailOrbit::parse(std::ifstream& strm)
+// Maps id to row for every record with a non-zero id.  Slots without a record hold -1.
+template<typename CLASS>
+static void indexRows(DysonSphereParser::Vector<int32_t>& rows, const DysonSphereParser::Vector<CLASS>& pool)
 {
-	read(strm, version);
-	if (version != 0)
+	int32_t maxId = 0;
+	for (const auto& record : pool)
+		maxId = std::max(maxId, record.id);
+	rows.assign(maxId + 1, -1);
+	for (size_t row = 0; row < pool.size(); ++row)
 	{
-		assert(false);
-		throw std::exception("Unexpected SailOrbit version");
+		if (pool[row].id > 0)
+			rows[pool[row].id] = static_cast<int32_t>(row);
 	}
-	read(strm, id);
-	read(strm, radius);
-	rotation.parse(strm);
-	up.parse(strm);
-	read(strm, count);
-	read(strm, enabled);
 }
 
-DysonSphereParser::ExpiryOrder::ExpiryOrder() :
-	time(0),
-	index(0)
+template<typename CLASS>
+void DysonSphereParser::EntityIndex::indexPool(const EComponentType type, const Vector<CLASS>& pool)
 {
+	Vector<int32_t>& rows = m_componentRows[static_cast<int32_t>(type)];
+	Vector<int32_t>& entities = m_componentEntities[static_cast<int32_t>(type)];
+	indexRows(rows, pool);
+	entities.assign(rows.size(), 0);
+	for (const auto& component : pool)
+	{
+		if (component.id > 0)
+			entities[component.id] = component.entityId;
+	}
 }
 
-void DysonSphereParser::ExpiryOrder::parse(std::ifstream& strm)
+void DysonSphereParser::EntityIndex::build(const PlanetFactory& factory)
 {
-	read(strm, time);
-	read(strm, index);
+	indexRows(m_entityRows, factory.entityPool);
+	indexPool(EComponentType::Belt, factory.cargoTraffic.beltPool);
+	indexPool(EComponentType::Splitter, factory.cargoTraffic.splitterPool);
+	indexPool(EComponentType::Storage, factory.factoryStorage.storagePool);
+	indexPool(EComponentType::Tank, factory.factoryStorage.tankPool);
+	indexPool(EComponentType::Miner, factory.factorySystem.minerPool);
+	indexPool(EComponentType::Inserter, factory.factorySystem.inserterPool);
+	indexPool(EComponentType::Assembler, factory.factorySystem.assemblerPool);
+	indexPool(EComponentType::Fractionate, factory.factorySystem.fractionatePool);
+	indexPool(EComponentType::Ejector, factory.factorySystem.ejectorPool);
+	indexPool(EComponentType::Silo, factory.factorySystem.siloPool);
+	indexPool(EComponentType::Lab, factory.factorySystem.labPool);
+	indexPool(EComponentType::Station, factory.transport.stationPool);
+	indexPool(EComponentType::PowerNode, factory.powerSystem.nodePool);
+	indexPool(EComponentType::PowerGenerator, factory.powerSystem.genPool);
+	indexPool(EComponentType::PowerConsumer, factory.powerSystem.consumerPool);
+	indexPool(EComponentType::PowerAccumulator, factory.powerSystem.accPool);
+	indexPool(EComponentType::PowerExchanger, factory.powerSystem.excPool);
+	indexPool(EComponentType::Monster, factory.monsterSystem.monsterPool);
 }
 
-DysonSphereParser::AbsorbOrder::AbsorbOrder() :
-	time(0),
-	index(0),
-	layer(0),
-	node(0)
+static int32_t lookup(const DysonSphereParser::Vector<int32_t>& table, const int32_t id, const int32_t missing)
 {
+	return id >= 0 && static_cast<size_t>(id) < table.size() ? table[id] : missing;
 }
 
-void DysonSphereParser::AbsorbOrder::parse(std::ifstream& strm)
+int32_t DysonSphereParser::EntityIndex::entityRow(const int32_t entityId) const
 {
-	read(strm, time);
-	read(strm, index);
-	read(strm, layer);
-	read(strm, node);
+	return lookup(m_entityRows, entityId, -1);
 }
 
-DysonSphereParser::SailBullet::SailBullet() :
-	version(0),
-	id(0),
-	t(0.0),
-	maxt(0.0),
-	state(0)
+int32_t DysonSphereParser::EntityIndex::componentRow(const EComponentType type, const int32_t componentId) const
 {
+	return lookup(m_componentRows[static_cast<int32_t>(type)], componentId, -1);
 }
 
-void DysonSphereParser::SailBullet::parse(std::ifstream& strm)
+int32_t DysonSphereParser::EntityIndex::entityOf(const EComponentType type, const int32_t componentId) const
 {
-	read(strm, version);
-	if (version != 0)
+	return lookup(m_componentEntities[static_cast<int32_t>(type)], componentId, 0);
+}
+
+int32_t DysonSphereParser::EntityIndex::componentOf(const EntityData& entity, const EComponentType type)
+{
+	if (type == EComponentType::Belt) return entity.beltId;
+	if (type == EComponentType::Splitter) return entity.splitterId;
+	if (type == EComponentType::Storage) return entity.storageId;
+	if (type == EComponentType::Tank) return entity.tankId;
+	if (type == EComponentType::Miner) return entity.minerId;
+	if (type == EComponentType::Inserter) return entity.inserterId;
+	if (type == EComponentType::Assembler) return entity.assemblerId;
+	if (type == EComponentType::Fractionate) return entity.fractionateId;
+	if (type == EComponentType::Ejector) return entity.ejectorId;
+	if (type == EComponentType::Silo) return entity.siloId;
+	if (type == EComponentType::Lab) return entity.labId;
+	if (type == EComponentType::Station) return entity.stationId;
+	if (type == EComponentType::PowerNode) return entity.powerNodeId;
+	if (type == EComponentType::PowerGenerator) return entity.powerGenId;
+	if (type == EComponentType::PowerConsumer) return entity.powerConId;
+	if (type == EComponentType::PowerAccumulator) return entity.powerAccId;
+	if (type == EComponentType::PowerExchanger) return entity.powerExcId;
+	if (type == EComponentType::Monster) return entity.monsterId;
+	return 0;
+}
+
+// Sorts edges into compressed sparse row form by a counting sort, keyed by source, or by target when
+// reverse is set.  targets receives the other end of each edge.
+static void compressEdges(const int32_t vertexCount, const DysonSphereParser::Vector<std::pair<int32_t, int32_t>>& edges, const bool reverse,
+	DysonSphereParser::Vector<int32_t>& offsets, DysonSphereParser::Vector<int32_t>& targets)
+{
+	offsets.assign(vertexCount + 1, 0);
+	for (const auto& edge : edges)
+		++offsets[(reverse ? edge.second : edge.first) + 1];
+	for (int32_t vertex = 0; vertex < vertexCount; ++vertex)
+		offsets[vertex + 1] += offsets[vertex];
+	DysonSphereParser::Vector<int32_t> cursor(offsets.begin(), offsets.end() - 1);
+	targets.resize(edges.size());
+	for (const auto& edge : edges)
+		targets[cursor[reverse ? edge.second : edge.first]++] = reverse ? edge.first : edge.second;
+}
+
+// Tarjan's algorithm with an explicit stack, so that belt lines thousands of belts long cannot overflow
+// the call stack.  Components are numbered in reverse topological order: no edge leads from a component
+// to one with a higher number.  Returns the number of components.
+static int32_t stronglyConnected(const DysonSphereParser::Vector<int32_t>& offsets, const DysonSphereParser::Vector<int32_t>& targets, DysonSphereParser::Vector<int32_t>& labels)
+{
+	const int32_t vertexCount = static_cast<int32_t>(offsets.size()) - 1;
+	DysonSphereParser::Vector<int32_t> order(vertexCount, -1);
+	DysonSphereParser::Vector<int32_t> low(vertexCount, 0);
+	DysonSphereParser::Vector<int32_t> stack;
+	DysonSphereParser::Vector<std::pair<int32_t, int32_t>> frames;  // Vertex and its next edge.
+	labels.assign(vertexCount, -1);
+	int32_t visited = 0;
+	int32_t count = 0;
+
+	for (int32_t root = 0; root < vertexCount; ++root)
 	{
-		assert(false);
-		throw std::exception("Unexpected SailBullet version");
+		if (order[root] >= 0)
+			continue;
+		order[root] = low[root] = visited++;
+		stack.push_back(root);
+		frames.push_back(std::make_pair(root, offsets[root]));
+		while (!frames.empty())
+		{
+			const int32_t vertex = frames.back().first;
+			if (frames.back().second < offsets[vertex + 1])
+			{
+				const int32_t next = targets[frames.back().second++];
+				if (order[next] < 0)
+				{
+					order[next] = low[next] = visited++;
+					stack.push_back(next);
+					frames.push_back(std::make_pair(next, offsets[next]));
+				}
+				else if (labels[next] < 0)
+				{
+					low[vertex] = std::min(low[vertex], order[next]);
+				}
+				continue;
+			}
+
+			frames.pop_back();
+			if (low[vertex] == order[vertex])
+			{
+				int32_t member = 0;
+				do
+				{
+					member = stack.back();
+					stack.pop_back();
+					labels[member] = count;
+				} while (member != vertex);
+				++count;
+			}
+			if (!frames.empty())
+				low[frames.back().first] = std::min(low[frames.back().first], low[vertex]);
+		}
 	}
-	read(strm, id);
-	read(strm, t);
-	read(strm, maxt);
-	read(strm, state);
-	rBegin.parse(strm);
-	rEnd.parse(strm);
-	lBegin.parse(strm);
-	uEndVel.parse(strm);
-	uBegin.parse(strm);
-	uEnd.parse(strm);
+	return count;
 }
 
-DysonSphereParser::DysonSwarm::DysonSwarm() :
-	version(0),
-	randSeed(0),
-	sailCapacity(0),
-	sailCursor(0),
-	sailRecycleCursor(0),
-	orbitCapacity(0),
-	orbitCursor(0),
-	numExpiryOrder(0),
-	expiryCursor(0),
-	expiryEnding(0),
-	numAbsorbOrder(0),
-	absorbCursor(0),
-	absorbEnding(0),
-	bulletCapacity(0),
-	bulletCursor(0),
-	bulletRecycleCursor(0)
+static int32_t findRoot(DysonSphereParser::Vector<int32_t>& parent, int32_t vertex)
 {
+	while (parent[vertex] != vertex)
+	{
+		parent[vertex] = parent[parent[vertex]];
+		vertex = parent[vertex];
+	}
+	return vertex;
 }
 
-void DysonSphereParser::DysonSwarm::parse(std::ifstream& strm)
+// Breadth-first walk of a CSR graph.  The result starts with start and is in order of distance.
+static DysonSphereParser::Vector<int32_t> reachable(const DysonSphereParser::Vector<int32_t>& offsets, const DysonSphereParser::Vector<int32_t>& targets, const int32_t start)
 {
-	read(strm, version);
-	if (version != 4)
+	DysonSphereParser::Vector<int32_t> result;
+	if (start < 0 || start + 1 >= static_cast<int32_t>(offsets.size()))
+		return result;
+	DysonSphereParser::Vector<uint8_t> seen(offsets.size() - 1, 0);
+	seen[start] = 1;
+	result.push_back(start);
+	for (size_t i = 0; i < result.size(); ++i)
 	{
-		assert(false);
-		throw std::exception("Unexpected DysonSwarm version");
+		const int32_t vertex = result[i];
+		for (int32_t edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+		{
+			if (!seen[targets[edge]])
+			{
+				seen[targets[edge]] = 1;
+				result.push_back(targets[edge]);
+			}
+		}
 	}
-	read(strm, randSeed);
-	read(strm, sailCapacity);
-	read(strm, sailCursor);
-	read(strm, sailRecycleCursor);
-	readv(strm, sailPoolForSave, sailCursor);
-	readv(strm, sailInfos, sailCursor);
-	read(strm, sailRecycle, sailRecycleCursor);
-	read(strm, orbitCapacity);
-	read(strm, orbitCursor);
-	readv(strm, orbits, orbitCursor - 1);
-	read(strm, numExpiryOrder);
-	read(strm, expiryCursor);
-	read(strm, expiryEnding);
-	readv(strm, expiryOrder, numExpiryOrder);
-	read(strm, numAbsorbOrder);
-	read(strm, absorbCursor);
-	read(strm, absorbEnding);
-	readv(strm, absorbOrder, numAbsorbOrder);
-	read(strm, bulletCapacity);
-	read(strm, bulletCursor);
-	read(strm, bulletRecycleCursor);
-	readv(strm, bulletPool, bulletCursor - 1);
-	read(strm, bulletRecycle, bulletRecycleCursor);
+	return result;
 }
 
-DysonSphereParser::DysonNode::DysonNode() :
-	version(0),
-	id(0),
-	protoId(0),
-	layerId(0),
-	use(false),
-	reserved(false),
-	sp(0),
-	spMax(0),
-	spOrdered(0),
-	cpOrdered(0),
-	rid(0),
-	frameTurn(0),
-	shellTurn(0),
-	_spReq(0),
-	_cpReq(0)
+DysonSphereParser::BeltGraph::BeltGraph() :
+	m_beltCount(0),
+	m_componentCount(0),
+	m_loopCount(0)
 {
 }
 
-void DysonSphereParser::DysonNode::parse(std::ifstream& strm)
+void DysonSphereParser::BeltGraph::build(const PlanetFactory& factory)
 {
-	read(strm, version);
-	if (version != 4)
+	const auto& belts = factory.cargoTraffic.beltPool;
+	const auto& splitters = factory.cargoTraffic.splitterPool;
+	m_beltCount = static_cast<int32_t>(belts.size());
+	const int32_t count = m_beltCount + static_cast<int32_t>(splitters.size());
+	indexRows(m_beltVertices, belts);
+	indexRows(m_splitterVertices, splitters);
+	for (auto& vertex : m_splitterVertices)
 	{
-		assert(false);
-		throw std::exception("Unexpected DysonNode version");
+		if (vertex >= 0)
+			vertex += m_beltCount;
+	}
+
+	// Both ends of a belt to belt link record it.  The inputs only add the links whose other end does not.
+	Vector<std::pair<int32_t, int32_t>> edges;
+	edges.reserve(belts.size() + 8 * splitters.size());
+	const auto addEdge = [&edges](const int32_t from, const int32_t to)
+	{
+		if (from >= 0 && to >= 0)
+			edges.push_back(std::make_pair(from, to));
+	};
+	for (int32_t vertex = 0; vertex < m_beltCount; ++vertex)
+	{
+		const BeltComponent& belt = belts[vertex];
+		if (belt.id <= 0)
+			continue;
+		addEdge(vertex, beltVertex(belt.outputId));
+		for (const int32_t inputId : { belt.backInputId, belt.leftInputId, belt.rightInputId })
+		{
+			const int32_t input = beltVertex(inputId);
+			if (input >= 0 && belts[input].outputId != belt.id)
+				addEdge(input, vertex);
+		}
+	}
+	for (const SplitterComponent& splitter : splitters)
+	{
+		const int32_t vertex = splitterVertex(splitter.id);
+		for (const int32_t inputId : { splitter.input0, splitter.input1, splitter.input2, splitter.input3 })
+			addEdge(beltVertex(inputId), vertex);
+		for (const int32_t outputId : { splitter.output0, splitter.output1, splitter.output2, splitter.output3 })
+			addEdge(vertex, beltVertex(outputId));
+	}
+
+	compressEdges(count, edges, false, m_offsets, m_targets);
+	compressEdges(count, edges, true, m_reverseOffsets, m_sources);
+
+	Vector<int32_t> parent(count);
+	std::iota(parent.begin(), parent.end(), 0);
+	for (const auto& edge : edges)
+		parent[findRoot(parent, edge.first)] = findRoot(parent, edge.second);
+	m_component.assign(count, -1);
+	m_componentCount = 0;
+	for (int32_t vertex = 0; vertex < count; ++vertex)
+	{
+		if ((isSplitter(vertex) ? splitters[row(vertex)].id : belts[vertex].id) <= 0)
+			continue;
+		const int32_t root = findRoot(parent, vertex);
+		if (m_component[root] < 0)
+			m_component[root] = m_componentCount++;
+		m_component[vertex] = m_component[root];
+	}
+
+	Vector<int32_t> strong;
+	const int32_t strongCount = stronglyConnected(m_offsets, m_targets, strong);
+	Vector<int32_t> strongSize(strongCount, 0);
+	for (const int32_t label : strong)
+		++strongSize[label];
+	for (const auto& edge : edges)
+	{
+		if (edge.first == edge.second)
+			strongSize[strong[edge.first]] = 2;
+	}
+	Vector<int32_t> loopIds(strongCount, -1);
+	m_loop.assign(count, -1);
+	m_loopCount = 0;
+	for (int32_t vertex = 0; vertex < count; ++vertex)
+	{
+		const int32_t label = strong[vertex];
+		if (strongSize[label] < 2)
+			continue;
+		if (loopIds[label] < 0)
+			loopIds[label] = m_loopCount++;
+		m_loop[vertex] = loopIds[label];
 	}
-	read(strm, id);
-	read(strm, protoId);
-	read(strm, layerId);
-	read(strm, use);
-	read(strm, reserved);
-	pos.parse(strm);
-	read(strm, sp);
-	read(strm, spMax);
-	read(strm, spOrdered);
-	read(strm, cpOrdered);
-	read(strm, rid);
-	read(strm, frameTurn);
-	read(strm, shellTurn);
-	read(strm, _spReq);
-	read(strm, _cpReq);
 }
 
-DysonSphereParser::DysonFrame::DysonFrame() :
-	version(0),
-	id(0),
-	protoId(0),
-	layerId(0),
-	reserved(false),
-	nodeId(0),
-	nodeId2(0),
-	euler(false),
-	spA(0),
-	spB(0),
-	spMax(0)
+int32_t DysonSphereParser::BeltGraph::beltVertex(const int32_t beltId) const
 {
+	return beltId > 0 ? lookup(m_beltVertices, beltId, -1) : -1;
 }
 
-void DysonSphereParser::DysonFrame::parse(std::ifstream& strm)
+int32_t DysonSphereParser::BeltGraph::splitterVertex(const int32_t splitterId) const
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected DysonFrame version");
-	}
-	read(strm, id);
-	read(strm, protoId);
-	read(strm, layerId);
-	read(strm, reserved);
-	read(strm, nodeId);
-	read(strm, nodeId2);
-	read(strm, euler);
-	read(strm, spA);
-	read(strm, spB);
-	read(strm, spMax);
+	return splitterId > 0 ? lookup(m_splitterVertices, splitterId, -1) : -1;
 }
 
-DysonSphereParser::DysonShell::DysonShell() :
-	version(0),
-	id(0),
-	protoId(0),
-	layerId(0),
-	randSeed(0),
-	numPolygon(0),
-	numDysonNode(0),
-	vertexCount(0),
-	triangleCount(0),
-	numVerts(0),
-	numPqArr(0),
-	numTris(0),
-	numVAdjs(0),
-	numVertAttr(0),
-	numVertsq(0),
-	numVertsqOffset(0),
-	numNodecps(0),
-	numVertcps(0),
-	vertRecycleArraySize(0),
-	vertRecycleCursor(0)
+DysonSphereParser::Vector<int32_t> DysonSphereParser::BeltGraph::downstream(const int32_t vertex) const
 {
+	return reachable(m_offsets, m_targets, vertex);
 }
 
-void DysonSphereParser::DysonShell::parse(std::ifstream& strm)
+DysonSphereParser::Vector<int32_t> DysonSphereParser::BeltGraph::upstream(const int32_t vertex) const
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected DysonShell version");
-	}
-	read(strm, id);
-	read(strm, protoId);
-	read(strm, layerId);
-	read(strm, randSeed);
-	read(strm, numPolygon);
-	readv(strm, polygon, numPolygon);
-	read(strm, numDysonNode);
-	read(strm, nodeId, numDysonNode);
-	read(strm, vertexCount);
-	read(strm, triangleCount);
-	read(strm, numVerts);
-	readv(strm, verts, numVerts);
-	read(strm, numPqArr);
-	readv(strm, pqArr, numPqArr);
-	read(strm, numTris);
-	read(strm, tris, numTris);
-	read(strm, numVAdjs);
-	read(strm, vAdjs, numVAdjs);
-	read(strm, numVertAttr);
-	read(strm, vertAttr, numVertAttr);
-	read(strm, numVertsq);
-	read(strm, vertsq, numVertsq);
-	read(strm, numVertsqOffset);
-	read(strm, vertsqOffset, numVertsqOffset);
-	read(strm, numNodecps);
-	read(strm, nodecps, numNodecps);
-	read(strm, numVertcps);
-	read(strm, vertcps, numVertcps);
-	read(strm, vertRecycleArraySize);
-	read(strm, vertRecycleCursor);
-	read(strm, vertRecycle, vertRecycleCursor);
+	return reachable(m_reverseOffsets, m_sources, vertex);
 }
 
-DysonSphereParser::DysonSphereLayer::DysonSphereLayer() :
-	version(0),
-	id(0),
-	orbitRadius(0.0),
-	orbitAngularSpeed(0.0),
-	currentAngle(0.0),
-	gridMode(0),
-	nodeCapacity(0),
-	nodeCursor(0),
-	nodeRecycleCursor(0),
-	frameCapacity(0),
-	frameCursor(0),
-	frameRecycleCursor(0),
-	shellCapacity(0),
-	shellCursor(0),
-	shellRecycleCursor(0)
+DysonSphereParser::CargoOccupancy::CargoOccupancy() :
+	cargoCount(0),
+	unknownCargo(0)
 {
 }
 
-void DysonSphereParser::DysonSphereLayer::parse(std::ifstream& strm)
+static int32_t lowestBit(const uint32_t mask)
 {
-	read(strm, version);
-	if (version != 0)
+#ifdef _MSC_VER
+	unsigned long index = 0;
+	_BitScanForward(&index, mask);
+	return static_cast<int32_t>(index);
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+// Calls found(position) for every byte of buffer equal to 246, the first byte of a cargo.  Only the
+// cargo heads are visited, so the cost per byte of belt is one compare whatever the belt carries.
+template<typename FUNCTION>
+static void forEachCargoHead(const DysonSphereParser::Vector<uint8_t>& buffer, FUNCTION found)
+{
+	const int32_t length = static_cast<int32_t>(buffer.size());
+	const uint8_t* const bytes = buffer.data();
+	int32_t position = 0;
+#if DSP_SSE2
+	const __m128i head = _mm_set1_epi8(static_cast<char>(246));
+	for (; position + 16 <= length; position += 16)
 	{
-		assert(false);
-		throw std::exception("Unexpected DysonSphereLayer version");
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + position));
+		uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, head)));
+		while (mask != 0)
+		{
+			found(position + lowestBit(mask));
+			mask &= mask - 1;
+		}
+	}
+#endif
+	for (; position < length; ++position)
+	{
+		if (bytes[position] == 246)
+			found(position);
+	}
+}
+
+void DysonSphereParser::CargoOccupancy::build(const PlanetFactory& factory)
+{
+	const auto& paths = factory.cargoTraffic.pathPool;
+	const auto& cargoPool = factory.cargoContainer.cargoPool;
+	pathCargo.assign(paths.size(), 0);
+	pathOccupancy.assign(paths.size(), 0.0f);
+	itemCounts.clear();
+	cargoCount = 0;
+	unknownCargo = 0;
+
+	for (size_t row = 0; row < paths.size(); ++row)
+	{
+		const Vector<uint8_t>& buffer = paths[row].buffer;
+		const int32_t length = static_cast<int32_t>(buffer.size());
+		int32_t count = 0;
+		forEachCargoHead(buffer, [&](const int32_t position)
+		{
+			if (position + cargoLength > length)
+				return;
+			const uint8_t* const digits = buffer.data() + position + 5;
+			const int32_t index = (digits[0] - 1) + (digits[1] - 1) * 100 + (digits[2] - 1) * 10000 + (digits[3] - 1) * 1000000;
+			++count;
+			if (index < 0 || static_cast<size_t>(index) >= cargoPool.size() || cargoPool[index].item <= 0)
+			{
+				++unknownCargo;
+				return;
+			}
+			const int32_t item = cargoPool[index].item;
+			if (static_cast<size_t>(item) >= itemCounts.size())
+				itemCounts.resize(item + 1, 0);
+			++itemCounts[item];
+		});
+		pathCargo[row] = count;
+		if (length > 0)
+			pathOccupancy[row] = std::min(1.0f, static_cast<float>(count * cargoLength) / static_cast<float>(length));
+		cargoCount += count;
+	}
+}
+
+void DysonSphereParser::CargoOccupancy::add(const CargoOccupancy& other)
+{
+	if (itemCounts.size() < other.itemCounts.size())
+		itemCounts.resize(other.itemCounts.size(), 0);
+	for (size_t item = 0; item < other.itemCounts.size(); ++item)
+		itemCounts[item] += other.itemCounts[item];
+	cargoCount += other.cargoCount;
+	unknownCargo += other.unknownCargo;
+}
+
+DysonSphereParser::CargoPathGraph::CargoPathGraph() :
+	m_componentCount(0),
+	m_loopCount(0)
+{
+}
+
+void DysonSphereParser::CargoPathGraph::build(const PlanetFactory& factory)
+{
+	const auto& paths = factory.cargoTraffic.pathPool;
+	const int32_t count = static_cast<int32_t>(paths.size());
+	indexRows(m_pathVertices, paths);
+
+	// Like belts, both ends of a link may record it.  The inputs only add the links the feeder does not.
+	Vector<std::pair<int32_t, int32_t>> edges;
+	edges.reserve(paths.size());
+	for (int32_t vertex = 0; vertex < count; ++vertex)
+	{
+		const CargoPath& path = paths[vertex];
+		if (path.id <= 0)
+			continue;
+		const int32_t output = pathVertex(path.outputPathIdForImport);
+		if (output >= 0)
+			edges.push_back(std::make_pair(vertex, output));
+		if (path.closed && output != vertex)
+			edges.push_back(std::make_pair(vertex, vertex));
+		for (const int32_t inputId : path.inputPaths)
+		{
+			const int32_t input = pathVertex(inputId);
+			if (input >= 0 && paths[input].outputPathIdForImport != path.id)
+				edges.push_back(std::make_pair(input, vertex));
+		}
+	}
+	compressEdges(count, edges, false, m_offsets, m_targets);
+	compressEdges(count, edges, true, m_reverseOffsets, m_sources);
+
+	// Tarjan numbers the components downstream first, so counting down puts them in topological order.
+	Vector<int32_t> strong;
+	m_componentCount = stronglyConnected(m_offsets, m_targets, strong);
+	m_component.resize(count);
+	for (int32_t vertex = 0; vertex < count; ++vertex)
+		m_component[vertex] = m_componentCount - 1 - strong[vertex];
+
+	Vector<int32_t> offsets(m_componentCount + 1, 0);
+	for (const int32_t component : m_component)
+		++offsets[component + 1];
+	for (int32_t component = 0; component < m_componentCount; ++component)
+		offsets[component + 1] += offsets[component];
+	m_order.resize(count);
+	for (int32_t vertex = 0; vertex < count; ++vertex)
+		m_order[offsets[m_component[vertex]]++] = vertex;
+
+	// A component is a loop when an edge stays inside it, which includes a path feeding itself.
+	Vector<uint8_t> cyclic(m_componentCount, 0);
+	for (const auto& edge : edges)
+	{
+		if (m_component[edge.first] == m_component[edge.second])
+			cyclic[m_component[edge.first]] = 1;
+	}
+	Vector<int32_t> loopIds(m_componentCount, -1);
+	m_loop.assign(count, -1);
+	m_loopCount = 0;
+	for (const int32_t vertex : m_order)
+	{
+		const int32_t component = m_component[vertex];
+		if (!cyclic[component])
+			continue;
+		if (loopIds[component] < 0)
+			loopIds[component] = m_loopCount++;
+		m_loop[vertex] = loopIds[component];
+	}
+}
+
+int32_t DysonSphereParser::CargoPathGraph::pathVertex(const int32_t pathId) const
+{
+	return pathId > 0 ? lookup(m_pathVertices, pathId, -1) : -1;
+}
+
+DysonSphereParser::Vector<int32_t> DysonSphereParser::CargoPathGraph::downstream(const int32_t vertex) const
+{
+	return reachable(m_offsets, m_targets, vertex);
+}
+
+DysonSphereParser::Vector<int32_t> DysonSphereParser::CargoPathGraph::upstream(const int32_t vertex) const
+{
+	return reachable(m_reverseOffsets, m_sources, vertex);
+}
+
+DysonSphereParser::PowerBalance::PowerBalance()
+{
+}
+
+// Adds the member of every record in pool to the total of its network.
+template<typename CLASS, typename TYPE>
+static void sumByNetwork(const DysonSphereParser::Vector<CLASS>& pool, TYPE CLASS::* member, DysonSphereParser::Vector<int64_t>& totals)
+{
+	for (const auto& record : pool)
+	{
+		if (record.id > 0 && record.networkId > 0 && static_cast<size_t>(record.networkId) < totals.size())
+			totals[record.networkId] += record.*member;
+	}
+}
+
+void DysonSphereParser::PowerBalance::build(const PlanetFactory& factory)
+{
+	const PowerSystem& power = factory.powerSystem;
+	int32_t maxNetworkId = 0;
+	int32_t maxNodeId = 0;
+	for (const PowerNetwork& network : power.netPool)
+	{
+		maxNetworkId = std::max(maxNetworkId, network.id);
+		for (const auto& node : network.nodes)
+			maxNodeId = std::max(maxNodeId, node.id);
+	}
+
+	const size_t size = static_cast<size_t>(maxNetworkId) + 1;
+	generation.assign(size, 0);
+	workDemand.assign(size, 0);
+	idleDemand.assign(size, 0);
+	storedEnergy.assign(size, 0);
+	storageCapacity.assign(size, 0);
+	nodeCount.assign(size, 0);
+	pieces.assign(size, 0);
+	sumByNetwork(power.genPool, &PowerGeneratorComponent::genEnergyPerTick, generation);
+	sumByNetwork(power.consumerPool, &PowerConsumerComponent::workEnergyPerTick, workDemand);
+	sumByNetwork(power.consumerPool, &PowerConsumerComponent::idleEnergyPerTick, idleDemand);
+	sumByNetwork(power.nodePool, &PowerNodeComponent::workEnergyPerTick, workDemand);
+	sumByNetwork(power.nodePool, &PowerNodeComponent::idleEnergyPerTick, idleDemand);
+	sumByNetwork(power.accPool, &PowerAccumulatorComponent::curEnergy, storedEnergy);
+	sumByNetwork(power.accPool, &PowerAccumulatorComponent::maxEnergy, storageCapacity);
+
+	// Node ids are unique within the factory, so one table from node id to position in the network
+	// serves every network, and is cleared again behind each one.
+	Vector<int32_t> positions(static_cast<size_t>(maxNodeId) + 1, -1);
+	Vector<int32_t> parent;
+	for (const PowerNetwork& network : power.netPool)
+	{
+		if (network.id <= 0)
+			continue;
+		const auto& nodes = network.nodes;
+		const int32_t count = static_cast<int32_t>(nodes.size());
+		for (int32_t i = 0; i < count; ++i)
+		{
+			if (nodes[i].id > 0)
+				positions[nodes[i].id] = i;
+		}
+		parent.resize(count);
+		std::iota(parent.begin(), parent.end(), 0);
+		for (int32_t i = 0; i < count; ++i)
+		{
+			for (const int32_t connId : nodes[i].connIdsForLoad)
+			{
+				const int32_t other = lookup(positions, connId, -1);
+				if (other >= 0)
+					parent[findRoot(parent, i)] = findRoot(parent, other);
+			}
+		}
+
+		int32_t roots = 0;
+		for (int32_t i = 0; i < count; ++i)
+		{
+			if (parent[i] == i)
+				++roots;
+		}
+		nodeCount[network.id] = count;
+		pieces[network.id] = roots;
+		for (const auto& node : nodes)
+		{
+			if (node.id > 0)
+				positions[node.id] = -1;
+		}
+	}
+}
+
+DysonSphereParser::PowerCoverageIndex::PowerCoverageIndex() :
+	m_origin{ 0.0f, 0.0f, 0.0f },
+	m_cellSize(1.0f),
+	m_dimensions{ 0, 0, 0 }
+{
+}
+
+void DysonSphereParser::PowerCoverageIndex::build(const PlanetFactory& factory)
+{
+	const auto& pool = factory.powerSystem.nodePool;
+	const int32_t count = static_cast<int32_t>(pool.size());
+	m_points.resize(count);
+	m_coverRadius2.assign(count, -1.0f);
+	float low[3] = { 0.0f, 0.0f, 0.0f };
+	float high[3] = { 0.0f, 0.0f, 0.0f };
+	float maxRadius = 0.0f;
+	int32_t used = 0;
+	for (int32_t row = 0; row < count; ++row)
+	{
+		const PowerNodeComponent& node = pool[row];
+		const float coordinates[3] = { node.powerPoint.x, node.powerPoint.y, node.powerPoint.z };
+		if (node.id <= 0 || !std::isfinite(coordinates[0]) || !std::isfinite(coordinates[1]) || !std::isfinite(coordinates[2]) || !std::isfinite(node.coverRadius))
+			continue;
+		for (int32_t axis = 0; axis < 3; ++axis)
+		{
+			low[axis] = used == 0 ? coordinates[axis] : std::min(low[axis], coordinates[axis]);
+			high[axis] = used == 0 ? coordinates[axis] : std::max(high[axis], coordinates[axis]);
+		}
+		const float radius = std::max(node.coverRadius, 0.0f);
+		m_points[row] = node.powerPoint;
+		m_coverRadius2[row] = radius * radius;
+		maxRadius = std::max(maxRadius, radius);
+		++used;
+	}
+
+	// Cells as wide as the widest cover, made wider while the grid would have many more cells than nodes.
+	// Extents are taken in double, where even the widest finite float range does not overflow.
+	const double cellLimit = std::max(64.0, 8.0 * used);
+	m_cellSize = std::max(maxRadius, 1.0f);
+	for (;;)
+	{
+		double cells = 1.0;
+		for (int32_t axis = 0; axis < 3; ++axis)
+			cells *= std::floor((static_cast<double>(high[axis]) - low[axis]) / m_cellSize) + 1.0;
+		if (cells <= cellLimit)
+			break;
+		m_cellSize *= 1.25f;
+	}
+	for (int32_t axis = 0; axis < 3; ++axis)
+	{
+		m_origin[axis] = low[axis];
+		m_dimensions[axis] = used == 0 ? 0 : static_cast<int32_t>((static_cast<double>(high[axis]) - low[axis]) / m_cellSize) + 1;
+	}
+
+	const int32_t cellCount = m_dimensions[0] * m_dimensions[1] * m_dimensions[2];
+	Vector<int32_t> cellOfNode(count, -1);
+	m_cellStart.assign(cellCount + 1, 0);
+	for (int32_t row = 0; row < count; ++row)
+	{
+		if (m_coverRadius2[row] < 0.0f)
+			continue;
+		const int32_t x = cellOf(m_points[row].x, 0);
+		const int32_t y = cellOf(m_points[row].y, 1);
+		const int32_t z = cellOf(m_points[row].z, 2);
+		cellOfNode[row] = (z * m_dimensions[1] + y) * m_dimensions[0] + x;
+		++m_cellStart[cellOfNode[row] + 1];
+	}
+	for (int32_t cell = 0; cell < cellCount; ++cell)
+		m_cellStart[cell + 1] += m_cellStart[cell];
+	Vector<int32_t> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+	m_nodes.resize(used);
+	for (int32_t row = 0; row < count; ++row)
+	{
+		if (cellOfNode[row] >= 0)
+			m_nodes[cursor[cellOfNode[row]]++] = row;
+	}
+}
+
+// The cell of a coordinate, clamped to the grid.
+int32_t DysonSphereParser::PowerCoverageIndex::cellOf(const float value, const int32_t axis) const
+{
+	const float cell = std::floor((value - m_origin[axis]) / m_cellSize);
+	if (!(cell > 0.0f))
+		return 0;
+	return cell < static_cast<float>(m_dimensions[axis]) ? static_cast<int32_t>(cell) : m_dimensions[axis] - 1;
+}
+
+float DysonSphereParser::PowerCoverageIndex::distance2(const int32_t node, const Vector3& point) const
+{
+	const float dx = m_points[node].x - point.x;
+	const float dy = m_points[node].y - point.y;
+	const float dz = m_points[node].z - point.z;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+// A point outside the grid is tested against the cells around the clamped cell.  Any node which covers
+// it is still among them, because the cells are at least as wide as the cover.
+int32_t DysonSphereParser::PowerCoverageIndex::coveringNode(const Vector3& point) const
+{
+	if (m_nodes.empty())
+		return -1;
+	const int32_t x = cellOf(point.x, 0);
+	const int32_t y = cellOf(point.y, 1);
+	const int32_t z = cellOf(point.z, 2);
+	int32_t best = -1;
+	float bestDistance2 = 0.0f;
+	for (int32_t cz = std::max(z - 1, 0); cz <= std::min(z + 1, m_dimensions[2] - 1); ++cz)
+	{
+		for (int32_t cy = std::max(y - 1, 0); cy <= std::min(y + 1, m_dimensions[1] - 1); ++cy)
+		{
+			for (int32_t cx = std::max(x - 1, 0); cx <= std::min(x + 1, m_dimensions[0] - 1); ++cx)
+			{
+				const int32_t cell = (cz * m_dimensions[1] + cy) * m_dimensions[0] + cx;
+				for (int32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+				{
+					const int32_t node = m_nodes[i];
+					const float d2 = distance2(node, point);
+					if (d2 <= m_coverRadius2[node] && (best < 0 || d2 < bestDistance2))
+					{
+						best = node;
+						bestDistance2 = d2;
+					}
+				}
+			}
+		}
+	}
+	return best;
+}
+
+// Searches shells of cells of growing Chebyshev distance around the cell of point.  Every cell of the next
+// shell is at least ring cells away, so the search stops once the best node found is closer than that.
+int32_t DysonSphereParser::PowerCoverageIndex::nearestNode(const Vector3& point) const
+{
+	if (m_nodes.empty())
+		return -1;
+	const int32_t x = cellOf(point.x, 0);
+	const int32_t y = cellOf(point.y, 1);
+	const int32_t z = cellOf(point.z, 2);
+	const int32_t maxRing = std::max(m_dimensions[0], std::max(m_dimensions[1], m_dimensions[2]));
+	int32_t best = -1;
+	float bestDistance2 = 0.0f;
+	for (int32_t ring = 0; ring <= maxRing; ++ring)
+	{
+		for (int32_t cz = std::max(z - ring, 0); cz <= std::min(z + ring, m_dimensions[2] - 1); ++cz)
+		{
+			for (int32_t cy = std::max(y - ring, 0); cy <= std::min(y + ring, m_dimensions[1] - 1); ++cy)
+			{
+				// Inside the shell only the two ends of each row of cells belong to it.
+				const bool face = std::abs(cz - z) == ring || std::abs(cy - y) == ring;
+				const int32_t step = face ? 1 : std::max(2 * ring, 1);
+				for (int32_t cx = x - ring; cx <= x + ring; cx += step)
+				{
+					if (cx < 0 || cx >= m_dimensions[0])
+						continue;
+					const int32_t cell = (cz * m_dimensions[1] + cy) * m_dimensions[0] + cx;
+					for (int32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+					{
+						const int32_t node = m_nodes[i];
+						const float d2 = distance2(node, point);
+						if (best < 0 || d2 < bestDistance2)
+						{
+							best = node;
+							bestDistance2 = d2;
+						}
+					}
+				}
+			}
+		}
+		const float reach = ring * m_cellSize;
+		if (best >= 0 && bestDistance2 <= reach * reach)
+			break;
+	}
+	return best;
+}
+
+DysonSphereParser::Vector<int32_t> DysonSphereParser::PowerCoverageIndex::coveringNodes(const Vector<EntityData>& entities) const
+{
+	Vector<int32_t> result(entities.size(), -1);
+	for (size_t row = 0; row < entities.size(); ++row)
+	{
+		if (entities[row].id > 0)
+			result[row] = coveringNode(entities[row].pos);
+	}
+	return result;
+}
+
+DysonSphereParser::Vector<int32_t> DysonSphereParser::PowerCoverageIndex::nearestNodes(const Vector<EntityData>& entities) const
+{
+	Vector<int32_t> result(entities.size(), -1);
+	for (size_t row = 0; row < entities.size(); ++row)
+	{
+		if (entities[row].id > 0)
+			result[row] = nearestNode(entities[row].pos);
+	}
+	return result;
+}
+
+DysonSphereParser::PlanetFactory::PlanetFactory() :
+	version(0),
+	planetId(0),
+	entityCapacity(0),
+	entityCursor(0),
+	entityRecycleCursor(0),
+	prebuildCapacity(0),
+	prebuildCursor(0),
+	prebuildRecycleCursor(0),
+	vegeCapacity(0),
+	vegeCursor(0),
+	vegeRecycleCursor(0),
+	veinCapacity(0),
+	veinCursor(0),
+	veinRecycleCursor(0)
+{
+}
+
+// Entities and prebuilds have 16 connection slots each.  The product is taken in 64 bits, since a corrupt
+// cursor would overflow it, and a negative result is kept negative so that the count check still fails.
+static int32_t connectionCount(DysonSphereParser::InputStream& strm, const int32_t cursor, const char* const field)
+{
+	const int64_t count = (static_cast<int64_t>(cursor) - 1) * 16;
+	if (count < 0)
+		return -1;
+	if (count > INT32_MAX)
+	{
+		strm.fail("PlanetFactory", field);
+		return 0;
+	}
+	return static_cast<int32_t>(count);
+}
+
+template<>
+void DysonSphereParser::PlanetFactory::parseVersion<1>(InputStream& strm)
+{
+	read(strm, planetId);
+	if (strm.options().visitor != nullptr)
+		strm.options().visitor->onFactoryBegin(planetId);
+	const Projection& projection = strm.options().projection;
+	parseOrSkip(strm, planet, projection.planet);
+	read(strm, entityCapacity);
+	read(strm, entityCursor);
+	read(strm, entityRecycleCursor);
+	if (projection.entities)
+	{
+		visitv(strm, entityPool, entityCursor - 1, &ParseVisitor::onEntity, "PlanetFactory", "entityPool");
+		if (strm.options().buildEntityTable)
+			entityTable.build(entityPool);
+		readv(strm, entityAnimPool, entityCursor - 1, "PlanetFactory", "entityAnimPool");
+		readv(strm, entitySignPool, entityCursor - 1, "PlanetFactory", "entitySignPool");
+		read(strm, entityConnPool, connectionCount(strm, entityCursor, "entityConnPool"), "PlanetFactory", "entityConnPool");
+		read(strm, entityRecycle, entityRecycleCursor, "PlanetFactory", "entityRecycle");
+	}
+	else
+	{
+		skipv<EntityData>(strm, entityCursor - 1, "PlanetFactory", "entityPool");
+		skipv<AnimData>(strm, entityCursor - 1, "PlanetFactory", "entityAnimPool");
+		skipv<SignData>(strm, entityCursor - 1, "PlanetFactory", "entitySignPool");
+		skipArray<int32_t>(strm, connectionCount(strm, entityCursor, "entityConnPool"));
+		skipArray<int32_t>(strm, entityRecycleCursor);
+	}
+	read(strm, prebuildCapacity);
+	read(strm, prebuildCursor);
+	read(strm, prebuildRecycleCursor);
+	if (projection.prebuilds)
+	{
+		readv(strm, prebuildPool, prebuildCursor - 1, "PlanetFactory", "prebuildPool");
+		read(strm, prebuildConnPool, connectionCount(strm, prebuildCursor, "prebuildConnPool"), "PlanetFactory", "prebuildConnPool");
+		read(strm, prebuildRecycle, prebuildRecycleCursor, "PlanetFactory", "prebuildRecycle");
+	}
+	else
+	{
+		skipv<PrebuildData>(strm, prebuildCursor - 1, "PlanetFactory", "prebuildPool");
+		skipArray<int32_t>(strm, connectionCount(strm, prebuildCursor, "prebuildConnPool"));
+		skipArray<int32_t>(strm, prebuildRecycleCursor);
+	}
+	read(strm, vegeCapacity);
+	read(strm, vegeCursor);
+	read(strm, vegeRecycleCursor);
+	if (projection.vegetation)
+	{
+		readv(strm, vegePool, vegeCursor - 1, "PlanetFactory", "vegePool");
+		read(strm, vegeRecycle, vegeRecycleCursor, "PlanetFactory", "vegeRecycle");
+	}
+	else
+	{
+		skipv<VegeData>(strm, vegeCursor - 1, "PlanetFactory", "vegePool");
+		skipArray<int32_t>(strm, vegeRecycleCursor);
+	}
+	read(strm, veinCapacity);
+	read(strm, veinCursor);
+	read(strm, veinRecycleCursor);
+	if (projection.veins)
+	{
+		readv(strm, veinPool, veinCursor - 1, "PlanetFactory", "veinPool");
+		read(strm, veinRecycle, veinRecycleCursor, "PlanetFactory", "veinRecycle");
+		readv(strm, veinAnimPool, veinCursor - 1, "PlanetFactory", "veinAnimPool");
+	}
+	else
+	{
+		skipv<VeinData>(strm, veinCursor - 1, "PlanetFactory", "veinPool");
+		skipArray<int32_t>(strm, veinRecycleCursor);
+		skipv<AnimData>(strm, veinCursor - 1, "PlanetFactory", "veinAnimPool");
+	}
+	parseOrSkip(strm, cargoContainer, projection.cargoContainer);
+	parseOrSkip(strm, cargoTraffic, projection.cargoTraffic);
+	parseOrSkip(strm, factoryStorage, projection.factoryStorage);
+	parseOrSkip(strm, powerSystem, projection.powerSystem);
+	parseOrSkip(strm, factorySystem, projection.factorySystem);
+	parseOrSkip(strm, transport, projection.transport);
+	parseOrSkip(strm, monsterSystem, projection.monsterSystem);
+	parseOrSkip(strm, platformSystem, projection.platformSystem);
+	if (strm.options().buildEntityIndex)
+		entityIndex.build(*this);
+}
+
+void DysonSphereParser::PlanetFactory::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("PlanetFactory", "version");
+}
+
+template<>
+void DysonSphereParser::PlanetFactory::serializeVersion<1>(OutputStream& strm) const
+{
+	write(strm, planetId);
+	planet.serialize(strm);
+	write(strm, entityCapacity);
+	write(strm, entityCursor);
+	write(strm, entityRecycleCursor);
+	writev(strm, entityPool);
+	writev(strm, entityAnimPool);
+	writev(strm, entitySignPool);
+	write(strm, entityConnPool);
+	write(strm, entityRecycle);
+	write(strm, prebuildCapacity);
+	write(strm, prebuildCursor);
+	write(strm, prebuildRecycleCursor);
+	writev(strm, prebuildPool);
+	write(strm, prebuildConnPool);
+	write(strm, prebuildRecycle);
+	write(strm, vegeCapacity);
+	write(strm, vegeCursor);
+	write(strm, vegeRecycleCursor);
+	writev(strm, vegePool);
+	write(strm, vegeRecycle);
+	write(strm, veinCapacity);
+	write(strm, veinCursor);
+	write(strm, veinRecycleCursor);
+	writev(strm, veinPool);
+	write(strm, veinRecycle);
+	writev(strm, veinAnimPool);
+	cargoContainer.serialize(strm);
+	cargoTraffic.serialize(strm);
+	factoryStorage.serialize(strm);
+	powerSystem.serialize(strm);
+	factorySystem.serialize(strm);
+	transport.serialize(strm);
+	monsterSystem.serialize(strm);
+	platformSystem.serialize(strm);
+}
+
+void DysonSphereParser::PlanetFactory::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::PlanetFactory::skip(InputStream& strm)
+{
+	int32_t version = 0;
+	int32_t planetId = 0;
+	read(strm, version);
+	read(strm, planetId);
+	PlanetData::skip(strm);
+	int32_t capacity = 0;
+	int32_t cursor = 0;
+	int32_t recycleCursor = 0;
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<EntityData>(strm, cursor - 1, "PlanetFactory", "entityPool");
+	skipv<AnimData>(strm, cursor - 1, "PlanetFactory", "entityAnimPool");
+	skipv<SignData>(strm, cursor - 1, "PlanetFactory", "entitySignPool");
+	skipArray<int32_t>(strm, connectionCount(strm, cursor, "entityConnPool"));
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<PrebuildData>(strm, cursor - 1, "PlanetFactory", "prebuildPool");
+	skipArray<int32_t>(strm, connectionCount(strm, cursor, "prebuildConnPool"));
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<VegeData>(strm, cursor - 1, "PlanetFactory", "vegePool");
+	skipArray<int32_t>(strm, recycleCursor);
+	read(strm, capacity);
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<VeinData>(strm, cursor - 1, "PlanetFactory", "veinPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	skipv<AnimData>(strm, cursor - 1, "PlanetFactory", "veinAnimPool");
+	CargoContainer::skip(strm);
+	CargoTraffic::skip(strm);
+	FactoryStorage::skip(strm);
+	PowerSystem::skip(strm);
+	FactorySystem::skip(strm);
+	PlanetTransport::skip(strm);
+	MonsterSystem::skip(strm);
+	PlatformSystem::skip(strm);
+}
+
+DysonSphereParser::PlanetFactoryHandle::PlanetFactoryHandle() :
+	planetId(0),
+	offset(0),
+	length(0)
+{
+}
+
+DysonSphereParser::PlanetFactoryHandle::PlanetFactoryHandle(const std::shared_ptr<PlanetFactory>& factory) :
+	planetId(factory->planetId),
+	offset(0),
+	length(0),
+	m_factory(factory)
+{
+}
+
+// Not thread-safe for a single handle, different handles may be loaded concurrently.
+DysonSphereParser::PlanetFactory& DysonSphereParser::PlanetFactoryHandle::get() const
+{
+	if (!m_factory)
+	{
+		if (!m_source)
+		{
+			assert(false);
+			throw std::exception("PlanetFactory handle has no source");
+		}
+		load(*m_source);
+	}
+	return *m_factory;
+}
+
+void DysonSphereParser::PlanetFactoryHandle::release()
+{
+	if (m_source)
+	{
+		m_factory.reset();
+		m_arena.reset();
+	}
+}
+
+// Arenas are not thread-safe, so with useArena every factory gets its own.  The handle owns it, so that
+// release() returns the memory and a reload starts on a fresh arena.
+DysonSphereParser::MonotonicArena* DysonSphereParser::PlanetFactoryHandle::createArena(const InputStream& strm) const
+{
+	m_arena = strm.options().useArena ? std::make_shared<MonotonicArena>() : nullptr;
+	return m_arena.get();
+}
+
+void DysonSphereParser::PlanetFactoryHandle::parse(InputStream& strm)
+{
+	ArenaScope scope(createArena(strm));
+	offset = strm.tellg();
+	m_factory = std::make_shared<PlanetFactory>();
+	m_factory->parse(strm);
+	planetId = m_factory->planetId;
+	length = strm.tellg() - offset;
+}
+
+// A failure stays with the handle.  The shared Stream mode source is recovered before it is unlocked
+// so that the other handles still load, and a half parsed factory is never cached.
+void DysonSphereParser::PlanetFactoryHandle::load(InputStream& source) const
+{
+	ArenaScope scope(createArena(source));
+	auto factory = std::make_shared<PlanetFactory>();
+	if (source.mode() == EInputMode::MemoryMapped)
+	{
+		InputStream cursor;
+		cursor.attach(source, offset);
+		factory->parse(cursor);
+		if (cursor.tellg() != offset + length)
+			cursor.fail("PlanetFactory", "length");
+		m_failure = cursor.failure();
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(source.mutex());
+		try
+		{
+			source.seekg(offset);
+			factory->parse(source);
+			if (source.tellg() != offset + length)
+				source.fail("PlanetFactory", "length");
+		}
+		catch (...)
+		{
+			source.recover();
+			throw;
+		}
+		m_failure = source.failure();
+		source.recover();
+	}
+	if (m_failure)
+		factory = std::make_shared<PlanetFactory>();
+	m_factory = factory;
+}
+
+DysonSphereParser::DysonSail::DysonSail() :
+	st(0.0),
+	gs(0.0)
+{
+}
+
+void DysonSphereParser::DysonSail::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::DysonSail::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::DysonSail::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
+}
+
+DysonSphereParser::DysonSailInfo::DysonSailInfo() :
+	orbit(0),
+	node(0),
+	kill(0)
+{
+}
+
+void DysonSphereParser::DysonSailInfo::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::DysonSailInfo::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::DysonSailInfo::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
+}
+
+DysonSphereParser::SailOrbit::SailOrbit() :
+	version(0),
+	id(0),
+	radius(0.0),
+	count(0),
+	enabled(false)
+{
+}
+
+void DysonSphereParser::SailOrbit::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::SailOrbit::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::SailOrbit::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
+}
+
+DysonSphereParser::ExpiryOrder::ExpiryOrder() :
+	time(0),
+	index(0)
+{
+}
+
+void DysonSphereParser::ExpiryOrder::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::ExpiryOrder::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::ExpiryOrder::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
+}
+
+DysonSphereParser::AbsorbOrder::AbsorbOrder() :
+	time(0),
+	index(0),
+	layer(0),
+	node(0)
+{
+}
+
+void DysonSphereParser::AbsorbOrder::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::AbsorbOrder::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::AbsorbOrder::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
+}
+
+DysonSphereParser::SailBullet::SailBullet() :
+	version(0),
+	id(0),
+	t(0.0),
+	maxt(0.0),
+	state(0)
+{
+}
+
+void DysonSphereParser::SailBullet::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::SailBullet::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::SailBullet::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
+}
+
+DysonSphereParser::DysonSwarm::DysonSwarm() :
+	version(0),
+	randSeed(0),
+	sailCapacity(0),
+	sailCursor(0),
+	sailRecycleCursor(0),
+	orbitCapacity(0),
+	orbitCursor(0),
+	numExpiryOrder(0),
+	expiryCursor(0),
+	expiryEnding(0),
+	numAbsorbOrder(0),
+	absorbCursor(0),
+	absorbEnding(0),
+	bulletCapacity(0),
+	bulletCursor(0),
+	bulletRecycleCursor(0)
+{
+}
+
+template<>
+void DysonSphereParser::DysonSwarm::parseVersion<4>(InputStream& strm)
+{
+	read(strm, randSeed);
+	read(strm, sailCapacity);
+	read(strm, sailCursor);
+	read(strm, sailRecycleCursor);
+	readv(strm, sailPoolForSave, sailCursor, "DysonSwarm", "sailPoolForSave");
+	readv(strm, sailInfos, sailCursor, "DysonSwarm", "sailInfos");
+	read(strm, sailRecycle, sailRecycleCursor, "DysonSwarm", "sailRecycle");
+	read(strm, orbitCapacity);
+	read(strm, orbitCursor);
+	readv(strm, orbits, orbitCursor - 1, "DysonSwarm", "orbits");
+	read(strm, numExpiryOrder);
+	read(strm, expiryCursor);
+	read(strm, expiryEnding);
+	readv(strm, expiryOrder, numExpiryOrder, "DysonSwarm", "expiryOrder");
+	read(strm, numAbsorbOrder);
+	read(strm, absorbCursor);
+	read(strm, absorbEnding);
+	readv(strm, absorbOrder, numAbsorbOrder, "DysonSwarm", "absorbOrder");
+	read(strm, bulletCapacity);
+	read(strm, bulletCursor);
+	read(strm, bulletRecycleCursor);
+	readv(strm, bulletPool, bulletCursor - 1, "DysonSwarm", "bulletPool");
+	read(strm, bulletRecycle, bulletRecycleCursor, "DysonSwarm", "bulletRecycle");
+}
+
+void DysonSphereParser::DysonSwarm::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("DysonSwarm", "version");
+}
+
+template<>
+void DysonSphereParser::DysonSwarm::serializeVersion<4>(OutputStream& strm) const
+{
+	write(strm, randSeed);
+	write(strm, sailCapacity);
+	write(strm, sailCursor);
+	write(strm, sailRecycleCursor);
+	writev(strm, sailPoolForSave);
+	writev(strm, sailInfos);
+	write(strm, sailRecycle);
+	write(strm, orbitCapacity);
+	write(strm, orbitCursor);
+	writev(strm, orbits);
+	write(strm, numExpiryOrder);
+	write(strm, expiryCursor);
+	write(strm, expiryEnding);
+	writev(strm, expiryOrder);
+	write(strm, numAbsorbOrder);
+	write(strm, absorbCursor);
+	write(strm, absorbEnding);
+	writev(strm, absorbOrder);
+	write(strm, bulletCapacity);
+	write(strm, bulletCursor);
+	write(strm, bulletRecycleCursor);
+	writev(strm, bulletPool);
+	write(strm, bulletRecycle);
+}
+
+void DysonSphereParser::DysonSwarm::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::DysonSwarm::skip(InputStream& strm)
+{
+	int32_t cursor = 0;
+	int32_t recycleCursor = 0;
+	int32_t count = 0;
+	strm.skip(12);  // version, randSeed, sailCapacity
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<DysonSail>(strm, cursor, "DysonSwarm", "sailPoolForSave");
+	skipv<DysonSailInfo>(strm, cursor, "DysonSwarm", "sailInfos");
+	skipArray<int32_t>(strm, recycleCursor);
+	strm.skip(4);  // orbitCapacity
+	read(strm, cursor);
+	skipv<SailOrbit>(strm, cursor - 1, "DysonSwarm", "orbits");
+	read(strm, count);
+	strm.skip(8);  // expiryCursor, expiryEnding
+	skipv<ExpiryOrder>(strm, count, "DysonSwarm", "expiryOrder");
+	read(strm, count);
+	strm.skip(8);  // absorbCursor, absorbEnding
+	skipv<AbsorbOrder>(strm, count, "DysonSwarm", "absorbOrder");
+	strm.skip(4);  // bulletCapacity
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<SailBullet>(strm, cursor - 1, "DysonSwarm", "bulletPool");
+	skipArray<int32_t>(strm, recycleCursor);
+}
+
+DysonSphereParser::DysonNode::DysonNode() :
+	version(0),
+	id(0),
+	protoId(0),
+	layerId(0),
+	use(false),
+	reserved(false),
+	sp(0),
+	spMax(0),
+	spOrdered(0),
+	cpOrdered(0),
+	rid(0),
+	frameTurn(0),
+	shellTurn(0),
+	_spReq(0),
+	_cpReq(0)
+{
+}
+
+void DysonSphereParser::DysonNode::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::DysonNode::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::DysonNode::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
+}
+
+DysonSphereParser::DysonFrame::DysonFrame() :
+	version(0),
+	id(0),
+	protoId(0),
+	layerId(0),
+	reserved(false),
+	nodeId(0),
+	nodeId2(0),
+	euler(false),
+	spA(0),
+	spB(0),
+	spMax(0)
+{
+}
+
+void DysonSphereParser::DysonFrame::parse(InputStream& strm)
+{
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::DysonFrame::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::DysonFrame::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
+}
+
+DysonSphereParser::DysonShell::DysonShell() :
+	version(0),
+	id(0),
+	protoId(0),
+	layerId(0),
+	randSeed(0),
+	numPolygon(0),
+	numDysonNode(0),
+	vertexCount(0),
+	triangleCount(0),
+	numVerts(0),
+	numPqArr(0),
+	numTris(0),
+	numVAdjs(0),
+	numVertAttr(0),
+	numVertsq(0),
+	numVertsqOffset(0),
+	numNodecps(0),
+	numVertcps(0),
+	vertRecycleArraySize(0),
+	vertRecycleCursor(0)
+{
+}
+
+template<>
+void DysonSphereParser::DysonShell::parseVersion<0>(InputStream& strm)
+{
+	read(strm, id);
+	read(strm, protoId);
+	read(strm, layerId);
+	read(strm, randSeed);
+	read(strm, numPolygon);
+	readv(strm, polygon, numPolygon, "DysonShell", "polygon");
+	read(strm, numDysonNode);
+	read(strm, nodeId, numDysonNode, "DysonShell", "nodeId");
+	read(strm, vertexCount);
+	read(strm, triangleCount);
+	read(strm, numVerts);
+	readv(strm, verts, numVerts, "DysonShell", "verts");
+	read(strm, numPqArr);
+	readv(strm, pqArr, numPqArr, "DysonShell", "pqArr");
+	read(strm, numTris);
+	read(strm, tris, numTris, "DysonShell", "tris");
+	read(strm, numVAdjs);
+	read(strm, vAdjs, numVAdjs, "DysonShell", "vAdjs");
+	read(strm, numVertAttr);
+	read(strm, vertAttr, numVertAttr, "DysonShell", "vertAttr");
+	read(strm, numVertsq);
+	read(strm, vertsq, numVertsq, "DysonShell", "vertsq");
+	read(strm, numVertsqOffset);
+	read(strm, vertsqOffset, numVertsqOffset, "DysonShell", "vertsqOffset");
+	read(strm, numNodecps);
+	read(strm, nodecps, numNodecps, "DysonShell", "nodecps");
+	read(strm, numVertcps);
+	read(strm, vertcps, numVertcps, "DysonShell", "vertcps");
+	read(strm, vertRecycleArraySize);
+	read(strm, vertRecycleCursor);
+	read(strm, vertRecycle, vertRecycleCursor, "DysonShell", "vertRecycle");
+}
+
+void DysonSphereParser::DysonShell::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("DysonShell", "version");
+}
+
+template<>
+void DysonSphereParser::DysonShell::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, id);
+	write(strm, protoId);
+	write(strm, layerId);
+	write(strm, randSeed);
+	write(strm, numPolygon);
+	writev(strm, polygon);
+	write(strm, numDysonNode);
+	write(strm, nodeId);
+	write(strm, vertexCount);
+	write(strm, triangleCount);
+	write(strm, numVerts);
+	writev(strm, verts);
+	write(strm, numPqArr);
+	writev(strm, pqArr);
+	write(strm, numTris);
+	write(strm, tris);
+	write(strm, numVAdjs);
+	write(strm, vAdjs);
+	write(strm, numVertAttr);
+	write(strm, vertAttr);
+	write(strm, numVertsq);
+	write(strm, vertsq);
+	write(strm, numVertsqOffset);
+	write(strm, vertsqOffset);
+	write(strm, numNodecps);
+	write(strm, nodecps);
+	write(strm, numVertcps);
+	write(strm, vertcps);
+	write(strm, vertRecycleArraySize);
+	write(strm, vertRecycleCursor);
+	write(strm, vertRecycle);
+}
+
+void DysonSphereParser::DysonShell::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::DysonShell::skip(InputStream& strm)
+{
+	int32_t count = 0;
+	strm.skip(20);  // version, id, protoId, layerId, randSeed
+	read(strm, count);
+	skipArray<float>(strm, count * 3);  // polygon
+	read(strm, count);
+	skipArray<int32_t>(strm, count);  // nodeId
+	strm.skip(8);  // vertexCount, triangleCount
+	read(strm, count);
+	skipArray<float>(strm, count * 3);  // verts
+	read(strm, count);
+	skipArray<int32_t>(strm, count * 2);  // pqArr
+	for (int32_t i = 0; i < 7; ++i)
+	{
+		// tris, vAdjs, vertAttr, vertsq, vertsqOffset, nodecps, vertcps
+		read(strm, count);
+		skipArray<int32_t>(strm, count);
 	}
+	strm.skip(4);  // vertRecycleArraySize
+	read(strm, count);
+	skipArray<int32_t>(strm, count);
+}
+
+DysonSphereParser::DysonSphereLayer::DysonSphereLayer() :
+	version(0),
+	id(0),
+	orbitRadius(0.0),
+	orbitAngularSpeed(0.0),
+	currentAngle(0.0),
+	gridMode(0),
+	nodeCapacity(0),
+	nodeCursor(0),
+	nodeRecycleCursor(0),
+	frameCapacity(0),
+	frameCursor(0),
+	frameRecycleCursor(0),
+	shellCapacity(0),
+	shellCursor(0),
+	shellRecycleCursor(0)
+{
+}
+
+template<>
+void DysonSphereParser::DysonSphereLayer::parseVersion<0>(InputStream& strm)
+{
 	read(strm, id);
 	read(strm, orbitRadius);
 	orbitRotation.parse(strm);
@@ -2825,18 +5489,80 @@ void DysonSphereParser::DysonSphereLayer::parse(std::ifstream& strm)
 	read(strm, nodeCapacity);
 	read(strm, nodeCursor);
 	read(strm, nodeRecycleCursor);
-	readi(strm, dysonNodeIndex, nodePool, nodeCursor - 1);
-	read(strm, nodeRecycle, nodeRecycleCursor);
+	readi(strm, dysonNodeIndex, nodePool, nodeCursor - 1, "DysonSphereLayer", "nodePool");
+	read(strm, nodeRecycle, nodeRecycleCursor, "DysonSphereLayer", "nodeRecycle");
 	read(strm, frameCapacity);
 	read(strm, frameCursor);
 	read(strm, frameRecycleCursor);
-	readi(strm, dysonFrameIndex, framePool, frameCursor - 1);
-	read(strm, frameRecycle, frameRecycleCursor);
+	readi(strm, dysonFrameIndex, framePool, frameCursor - 1, "DysonSphereLayer", "framePool");
+	read(strm, frameRecycle, frameRecycleCursor, "DysonSphereLayer", "frameRecycle");
 	read(strm, shellCapacity);
 	read(strm, shellCursor);
 	read(strm, shellRecycleCursor);
-	readi(strm, dysonShellIndex, shellPool, shellCursor - 1);
-	read(strm, shellRecycle, shellRecycleCursor);
+	visiti(strm, dysonShellIndex, shellPool, shellCursor - 1, &ParseVisitor::onDysonShell, "DysonSphereLayer", "shellPool");
+	read(strm, shellRecycle, shellRecycleCursor, "DysonSphereLayer", "shellRecycle");
+}
+
+void DysonSphereParser::DysonSphereLayer::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("DysonSphereLayer", "version");
+}
+
+template<>
+void DysonSphereParser::DysonSphereLayer::serializeVersion<0>(OutputStream& strm) const
+{
+	write(strm, id);
+	write(strm, orbitRadius);
+	orbitRotation.serialize(strm);
+	write(strm, orbitAngularSpeed);
+	write(strm, currentAngle);
+	currentRotation.serialize(strm);
+	nextRotation.serialize(strm);
+	write(strm, gridMode);
+	write(strm, nodeCapacity);
+	write(strm, nodeCursor);
+	write(strm, nodeRecycleCursor);
+	writei(strm, dysonNodeIndex, nodePool, nodeCursor - 1);
+	write(strm, nodeRecycle);
+	write(strm, frameCapacity);
+	write(strm, frameCursor);
+	write(strm, frameRecycleCursor);
+	writei(strm, dysonFrameIndex, framePool, frameCursor - 1);
+	write(strm, frameRecycle);
+	write(strm, shellCapacity);
+	write(strm, shellCursor);
+	write(strm, shellRecycleCursor);
+	writei(strm, dysonShellIndex, shellPool, shellCursor - 1);
+	write(strm, shellRecycle);
+}
+
+void DysonSphereParser::DysonSphereLayer::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::DysonSphereLayer::skip(InputStream& strm)
+{
+	int32_t cursor = 0;
+	int32_t recycleCursor = 0;
+	strm.skip(76);  // version, id, orbitRadius, orbitRotation, orbitAngularSpeed, currentAngle, currentRotation, nextRotation, gridMode, nodeCapacity
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipi<DysonNode>(strm, cursor - 1, "DysonSphereLayer", "nodePool");
+	skipArray<int32_t>(strm, recycleCursor);
+	strm.skip(4);  // frameCapacity
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipi<DysonFrame>(strm, cursor - 1, "DysonSphereLayer", "framePool");
+	skipArray<int32_t>(strm, recycleCursor);
+	strm.skip(4);  // shellCapacity
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipi<DysonShell>(strm, cursor - 1, "DysonSphereLayer", "shellPool");
+	skipArray<int32_t>(strm, recycleCursor);
 }
 
 DysonSphereParser::DysonRocket::DysonRocket() :
@@ -2850,24 +5576,19 @@ DysonSphereParser::DysonRocket::DysonRocket() :
 {
 }
 
-void DysonSphereParser::DysonRocket::parse(std::ifstream& strm)
+void DysonSphereParser::DysonRocket::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected DysonRocket version");
-	}
-	read(strm, id);
-	read(strm, nodeLayerId);
-	read(strm, nodeId);
-	read(strm, planetId);
-	read(strm, t);
-	read(strm, uSpeed);
-	uPos.parse(strm);
-	uRot.parse(strm);
-	uVel.parse(strm);
-	launch.parse(strm);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::DysonRocket::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::DysonRocket::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::DysonNodeRData::DysonNodeRData() :
@@ -2878,19 +5599,19 @@ DysonSphereParser::DysonNodeRData::DysonNodeRData() :
 {
 }
 
-void DysonSphereParser::DysonNodeRData::parse(std::ifstream& strm)
+void DysonSphereParser::DysonNodeRData::parse(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected DysonNodeRData version");
-	}
-	read(strm, id);
-	read(strm, layerId);
-	pos.parse(strm);
-	read(strm, angularVel);
-	layerRot.parse(strm);
+	schemaParse(strm, *this);
+}
+
+void DysonSphereParser::DysonNodeRData::serialize(OutputStream& strm) const
+{
+	schemaWrite(strm, *this);
+}
+
+void DysonSphereParser::DysonNodeRData::skip(InputStream& strm)
+{
+	strm.skip(recordSize);
 }
 
 DysonSphereParser::DysonSphere::DysonSphere() :
@@ -2910,49 +5631,364 @@ DysonSphereParser::DysonSphere::DysonSphere() :
 {
 }
 
-void DysonSphereParser::DysonSphere::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::DysonSphere::parseVersion<2>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 2)
-	{
-		assert(false);
-		throw std::exception("Unexpected DysonSphere version");
-	}
 	read(strm, randSeed);
 	swarm.parse(strm);
 	read(strm, twelveTwelve);
 	if (twelveTwelve != 1212)
+		strm.fail("DysonSphere", "twelveTwelve");
+	read(strm, layerCount);
+	read(strm, numDysonSphereLayer);
+	readi(strm, dysonSphereLayerIndex, dysonSphereLayer, numDysonSphereLayer - 1, "DysonSphere", "dysonSphereLayer");
+	read(strm, rocketCapacity);
+	read(strm, rocketCursor);
+	read(strm, rocketRecycleCursor);
+	readv(strm, rocketPool, rocketCursor - 1, "DysonSphere", "rocketPool");
+	read(strm, rocketRecycle, rocketRecycleCursor, "DysonSphere", "rocketRecycle");
+	read(strm, autoNodeCount);
+	read(strm, numAutoNodes);
+	if (!strm.checkCount(numAutoNodes, sizeof(int32_t), "DysonSphere", "autoNodes"))
+		return;
+	autoNodeIncludedFlag.resize(numAutoNodes);
+	for (auto it = autoNodeIncludedFlag.begin(); it != autoNodeIncludedFlag.end(); ++it)
+	{
+		read(strm, *it);
+		if (*it > 0)
+		{
+			layerId.push_back(0);
+			read(strm, *layerId.rbegin());
+			nodeId.push_back(0);
+			read(strm, *nodeId.rbegin());
+		}
+	}
+	read(strm, nrdCapacity);
+	read(strm, nrdCursor);
+	read(strm, nrdRecycleCursor);
+	readv(strm, nrdPool, nrdCursor - 1, "DysonSphere", "nrdPool");
+	read(strm, nrdRecycle, nrdRecycleCursor, "DysonSphere", "nrdRecycle");
+}
+
+void DysonSphereParser::DysonSphere::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("DysonSphere", "version");
+}
+
+template<>
+void DysonSphereParser::DysonSphere::serializeVersion<2>(OutputStream& strm) const
+{
+	write(strm, randSeed);
+	swarm.serialize(strm);
+	write(strm, twelveTwelve);
+	write(strm, layerCount);
+	write(strm, numDysonSphereLayer);
+	writei(strm, dysonSphereLayerIndex, dysonSphereLayer, numDysonSphereLayer - 1);
+	write(strm, rocketCapacity);
+	write(strm, rocketCursor);
+	write(strm, rocketRecycleCursor);
+	writev(strm, rocketPool);
+	write(strm, rocketRecycle);
+	write(strm, autoNodeCount);
+	write(strm, numAutoNodes);
+	for (size_t i = 0, next = 0; i < autoNodeIncludedFlag.size(); ++i)
+	{
+		write(strm, autoNodeIncludedFlag[i]);
+		if (autoNodeIncludedFlag[i] > 0 && next < layerId.size())
+		{
+			write(strm, layerId[next]);
+			write(strm, nodeId[next]);
+			++next;
+		}
+	}
+	write(strm, nrdCapacity);
+	write(strm, nrdCursor);
+	write(strm, nrdRecycleCursor);
+	writev(strm, nrdPool);
+	write(strm, nrdRecycle);
+}
+
+void DysonSphereParser::DysonSphere::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::DysonSphere::skip(InputStream& strm)
+{
+	int32_t count = 0;
+	int32_t cursor = 0;
+	int32_t recycleCursor = 0;
+	strm.skip(8);  // version, randSeed
+	DysonSwarm::skip(strm);
+	strm.skip(8);  // twelveTwelve, layerCount
+	read(strm, count);
+	skipi<DysonSphereLayer>(strm, count - 1, "DysonSphere", "dysonSphereLayer");
+	strm.skip(4);  // rocketCapacity
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<DysonRocket>(strm, cursor - 1, "DysonSphere", "rocketPool");
+	skipArray<int32_t>(strm, recycleCursor);
+	strm.skip(4);  // autoNodeCount
+	read(strm, count);
+	if (!strm.checkCount(count, sizeof(int32_t), "DysonSphere", "autoNodes"))
+		return;
+	for (int32_t i = 0; i < count && strm; ++i)
+	{
+		int32_t autoNodeIncludedFlag = 0;
+		read(strm, autoNodeIncludedFlag);
+		if (autoNodeIncludedFlag > 0)
+			strm.skip(8);  // layerId, nodeId
+	}
+	strm.skip(4);  // nrdCapacity
+	read(strm, cursor);
+	read(strm, recycleCursor);
+	skipv<DysonNodeRData>(strm, cursor - 1, "DysonSphere", "nrdPool");
+	skipArray<int32_t>(strm, recycleCursor);
+}
+
+DysonSphereParser::SectionIndex::SectionIndex() :
+	fileSize(0),
+	modifiedTime(0),
+	statisticsOffset(0),
+	playerOffset(0),
+	factoriesOffset(0),
+	dysonSpheresOffset(0),
+	endOffset(0)
+{
+}
+
+// The sidecar is a cache for this machine, so it is written in host byte order.  A sidecar from a
+// host of the other byte order fails the magic check and is rewritten.
+static const uint32_t sectionIndexMagic = 0x58444953;  // "SIDX"
+static const int32_t sectionIndexVersion = 1;
+
+static bool fileStamp(const std::filesystem::path& path, int64_t& size, int64_t& modifiedTime)
+{
+	std::error_code error;
+	size = static_cast<int64_t>(std::filesystem::file_size(path, error));
+	if (error)
+		return false;
+	modifiedTime = static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+	return !error;
+}
+
+template<typename TYPE>
+static void writeRaw(std::ofstream& file, const TYPE& value)
+{
+	file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename TYPE>
+static void writeRaw(std::ofstream& file, const std::vector<TYPE>& vect)
+{
+	writeRaw(file, static_cast<int32_t>(vect.size()));
+	file.write(reinterpret_cast<const char*>(vect.data()), vect.size() * sizeof(TYPE));
+}
+
+template<typename TYPE>
+static void readRaw(std::ifstream& file, TYPE& value)
+{
+	file.read(reinterpret_cast<char*>(&value), sizeof(value));
+}
+
+template<typename TYPE>
+static void readRaw(std::ifstream& file, std::vector<TYPE>& vect)
+{
+	int32_t size = 0;
+	readRaw(file, size);
+	if (!file || size < 0 || size > (1 << 24))
+	{
+		file.setstate(std::ios_base::failbit);
+		return;
+	}
+	vect.resize(size);
+	file.read(reinterpret_cast<char*>(vect.data()), vect.size() * sizeof(TYPE));
+}
+
+std::filesystem::path DysonSphereParser::SectionIndex::sidecarPath(const std::filesystem::path& savePath)
+{
+	std::filesystem::path path = savePath;
+	path += ".idx";
+	return path;
+}
+
+bool DysonSphereParser::SectionIndex::load(const std::filesystem::path& savePath)
+{
+	int64_t currentSize = 0;
+	int64_t currentTime = 0;
+	if (!fileStamp(savePath, currentSize, currentTime))
+		return false;
+
+	std::ifstream file(sidecarPath(savePath), std::ios_base::binary);
+	uint32_t magic = 0;
+	int32_t version = 0;
+	readRaw(file, magic);
+	readRaw(file, version);
+	if (!file || magic != sectionIndexMagic || version != sectionIndexVersion)
+		return false;
+
+	readRaw(file, fileSize);
+	readRaw(file, modifiedTime);
+	readRaw(file, statisticsOffset);
+	readRaw(file, playerOffset);
+	readRaw(file, factoriesOffset);
+	readRaw(file, dysonSpheresOffset);
+	readRaw(file, endOffset);
+	readRaw(file, planetIds);
+	readRaw(file, factoryOffsets);
+	readRaw(file, factoryLengths);
+	readRaw(file, dysonSphereIndex);
+	readRaw(file, dysonSphereOffsets);
+	if (!file || fileSize != currentSize || modifiedTime != currentTime)
+		return false;
+	return planetIds.size() == factoryOffsets.size() && planetIds.size() == factoryLengths.size()
+		&& dysonSphereIndex.size() == dysonSphereOffsets.size() && endOffset <= fileSize;
+}
+
+bool DysonSphereParser::SectionIndex::save(const std::filesystem::path& savePath) const
+{
+	SectionIndex stamped(*this);
+	if (!fileStamp(savePath, stamped.fileSize, stamped.modifiedTime))
+		return false;
+
+	std::ofstream file(sidecarPath(savePath), std::ios_base::binary | std::ios_base::trunc);
+	writeRaw(file, sectionIndexMagic);
+	writeRaw(file, sectionIndexVersion);
+	writeRaw(file, stamped.fileSize);
+	writeRaw(file, stamped.modifiedTime);
+	writeRaw(file, statisticsOffset);
+	writeRaw(file, playerOffset);
+	writeRaw(file, factoriesOffset);
+	writeRaw(file, dysonSpheresOffset);
+	writeRaw(file, endOffset);
+	writeRaw(file, planetIds);
+	writeRaw(file, factoryOffsets);
+	writeRaw(file, factoryLengths);
+	writeRaw(file, dysonSphereIndex);
+	writeRaw(file, dysonSphereOffsets);
+	return file.good();
+}
+
+// Bump snapshotVersion when a snapshot table changes or a raw record changes layout but not size.
+static const uint32_t snapshotMagic = 0x50414E53;  // "SNAP"
+static const int32_t snapshotVersion = 2;
+
+std::filesystem::path DysonSphereParser::GameSave::snapshotPath(const std::filesystem::path& savePath)
+{
+	std::filesystem::path path = savePath;
+	path += ".snap";
+	return path;
+}
+
+bool DysonSphereParser::GameSave::loadSnapshot(const std::filesystem::path& savePath, const ParseOptions& options)
+{
+	int64_t currentSize = 0;
+	int64_t currentTime = 0;
+	if (!fileStamp(savePath, currentSize, currentTime))
+		return false;
+
+	// Mapped, so every raw pool is a single copy out of the mapping.
+	ParseOptions snapshotOptions;
+	snapshotOptions.errorMode = EErrorMode::Report;
+	InputStream strm;
+	strm.setOptions(snapshotOptions);
+	if (!strm.open(snapshotPath(savePath).c_str(), EInputMode::MemoryMapped))
+		return false;
+
+	uint32_t magic = 0;
+	int32_t version = 0;
+	int64_t fileSize = 0;
+	int64_t modifiedTime = 0;
+	snapshotRead(strm, magic);
+	snapshotRead(strm, version);
+	snapshotRead(strm, fileSize);
+	snapshotRead(strm, modifiedTime);
+	if (!strm.good() || magic != snapshotMagic || version != snapshotVersion || fileSize != currentSize || modifiedTime != currentTime)
+		return false;
+
+	snapshotRead(strm, *this);
+	if (strm.failure() || strm.tellg() != strm.length())
+		return false;
+
+	for (const auto& factory : data.factories)
+	{
+		if (options.buildEntityTable)
+			factory->entityTable.build(factory->entityPool);
+		if (options.buildEntityIndex)
+			factory->entityIndex.build(*factory);
+	}
+	return true;
+}
+
+bool DysonSphereParser::GameSave::saveSnapshot(const std::filesystem::path& savePath) const
+{
+	int64_t fileSize = 0;
+	int64_t modifiedTime = 0;
+	if (!fileStamp(savePath, fileSize, modifiedTime))
+		return false;
+
+	const std::filesystem::path path = snapshotPath(savePath);
+	std::ofstream file(path, std::ios_base::binary | std::ios_base::trunc);
+	snapshotWrite(file, snapshotMagic);
+	snapshotWrite(file, snapshotVersion);
+	snapshotWrite(file, fileSize);
+	snapshotWrite(file, modifiedTime);
+	snapshotWrite(file, *this);
+	file.close();
+
+	// A lazy factory which failed to load would be stored as parsed so far.
+	const bool valid = file.good() && std::none_of(data.factories.begin(), data.factories.end(), [](const PlanetFactoryHandle& factory)
+	{
+		return static_cast<bool>(factory.failure());
+	});
+	if (!valid)
 	{
-		assert(false);
-		throw std::exception("Unexpected DysonSphere twelveTwelve");
+		std::error_code error;
+		std::filesystem::remove(path, error);
 	}
-	read(strm, layerCount);
-	read(strm, numDysonSphereLayer);
-	readi(strm, dysonSphereLayerIndex, dysonSphereLayer, numDysonSphereLayer - 1);
-	read(strm, rocketCapacity);
-	read(strm, rocketCursor);
-	read(strm, rocketRecycleCursor);
-	readv(strm, rocketPool, rocketCursor - 1);
-	read(strm, rocketRecycle, rocketRecycleCursor);
-	read(strm, autoNodeCount);
-	read(strm, numAutoNodes);
-	autoNodeIncludedFlag.resize(numAutoNodes);
-	for (auto it = autoNodeIncludedFlag.begin(); it != autoNodeIncludedFlag.end(); ++it)
+	return valid;
+}
+
+template<typename FUNCTION>
+static void parallelFor(const int32_t count, int32_t threadCount, FUNCTION function)
+{
+	if (threadCount <= 0)
+		threadCount = static_cast<int32_t>(std::max(1u, std::thread::hardware_concurrency()));
+	threadCount = std::min(threadCount, count);
+
+	std::atomic<int32_t> next(0);
+	std::exception_ptr failure;
+	std::mutex failureMutex;
+	auto worker = [&]()
 	{
-		read(strm, *it);
-		if (*it > 0)
+		for (int32_t i = next++; i < count; i = next++)
 		{
-			layerId.push_back(0);
-			read(strm, *layerId.rbegin());
-			nodeId.push_back(0);
-			read(strm, *nodeId.rbegin());
+			try
+			{
+				function(i);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(failureMutex);
+				if (!failure)
+					failure = std::current_exception();
+				next = count;
+			}
 		}
-	}
-	read(strm, nrdCapacity);
-	read(strm, nrdCursor);
-	read(strm, nrdRecycleCursor);
-	readv(strm, nrdPool, nrdCursor - 1);
-	read(strm, nrdRecycle, nrdRecycleCursor);
+	};
+
+	std::vector<std::thread> threads;
+	for (int32_t i = 1; i < threadCount; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& thread : threads)
+		thread.join();
+
+	if (failure)
+		std::rethrow_exception(failure);
 }
 
 DysonSphereParser::GameData::GameData() :
@@ -2966,14 +6002,9 @@ DysonSphereParser::GameData::GameData() :
 {
 }
 
-void DysonSphereParser::GameData::parse(std::ifstream& strm)
+template<>
+void DysonSphereParser::GameData::parseVersion<2>(InputStream& strm)
 {
-	read(strm, version);
-	if (version != 2)
-	{
-		assert(false);
-		throw std::exception("Unexpected GameData version");
-	}
 	read(strm, gameName);
 	gameDesc.parse(strm);
 	read(strm, gameTick);
@@ -2981,14 +6012,235 @@ void DysonSphereParser::GameData::parse(std::ifstream& strm)
 	history.parse(strm);
 	read(strm, hidePlayerModel);
 	read(strm, disableController);
-	statistics.parse(strm);
+
+	// Unselected sections are jumped over when there is a valid SectionIndex.  The statistics are
+	// followed by planetId, so they end just before the player.
+	const SectionIndex* const index = strm.sectionIndex();
+	const Projection& projection = strm.options().projection;
+	sections = SectionIndex();
+	sections.statisticsOffset = strm.tellg();
+	if (projection.statistics)
+		statistics.parse(strm);
+	else if (index != nullptr)
+		strm.seekg(index->playerOffset - static_cast<int64_t>(sizeof(planetId)));
+	else
+		GameStatData().parse(strm);
 	read(strm, planetId);
-	mainPlayer.parse(strm);
+	sections.playerOffset = strm.tellg();
+	if (projection.mainPlayer)
+		mainPlayer.parse(strm);
+	else if (index != nullptr)
+		strm.seekg(index->factoriesOffset);
+	else
+		Player().parse(strm);
+	sections.factoriesOffset = strm.tellg();
 	read(strm, factoryCount);
 	galacticTransport.parse(strm);
-	readv(strm, factories, factoryCount);
+	if (!projection.factories)
+	{
+		scanFactories(strm);
+		recordFactories();
+		factories.clear();
+	}
+	else if (strm.options().visitor != nullptr)
+	{
+		if (factoryCount > 0 && strm.checkCount(factoryCount, sizeof(int32_t), "GameData", "factoryCount"))
+		{
+			// Each factory is dropped after onFactoryEnd(), and with useArena its arena along with it.
+			factories.resize(factoryCount);
+			for (auto& factory : factories)
+			{
+				factory.parse(strm);
+				strm.options().visitor->onFactoryEnd(*factory.m_factory);
+				factory.m_factory.reset();
+				factory.m_arena.reset();
+			}
+		}
+	}
+	else if (strm.options().lazyFactories)
+	{
+		scanFactories(strm);
+		const auto source = strm.shared_from_this();
+		for (auto& factory : factories)
+			factory.m_source = source;
+	}
+	else if (strm.options().parallelFactories && strm.mode() == EInputMode::MemoryMapped && factoryCount > 1)
+	{
+		parseFactories(strm);
+	}
+	else if (factoryCount > 0 && strm.checkCount(factoryCount, sizeof(int32_t), "GameData", "factoryCount"))
+	{
+		factories.resize(factoryCount);
+		for (auto& factory : factories)
+			factory.parse(strm);
+	}
+	if (projection.factories)
+		recordFactories();
+
+	sections.dysonSpheresOffset = strm.tellg();
 	read(strm, galaxyStarCount);
-	readi(strm, dysonSphereIndex, dysonSpheres, galaxyStarCount);
+	if (!projection.dysonSpheres && index != nullptr)
+	{
+		sections.dysonSphereIndex = index->dysonSphereIndex;
+		sections.dysonSphereOffsets = index->dysonSphereOffsets;
+		strm.seekg(index->endOffset);
+	}
+	else if (galaxyStarCount <= 0 || strm.checkCount(galaxyStarCount, sizeof(int32_t), "GameData", "galaxyStarCount"))
+	{
+		for (int32_t i = 0; i < galaxyStarCount; ++i)
+		{
+			int32_t starIndex = 0;
+			read(strm, starIndex);
+			if (starIndex != 0)
+			{
+				sections.dysonSphereIndex.push_back(starIndex);
+				sections.dysonSphereOffsets.push_back(strm.tellg());
+				if (projection.dysonSpheres)
+				{
+					if (strm.options().visitor != nullptr)
+						strm.options().visitor->onDysonSphereBegin(starIndex);
+					dysonSphereIndex.push_back(starIndex);
+					dysonSphereSlot.push_back(i);
+					dysonSpheres.push_back(DysonSphere());
+					dysonSpheres.rbegin()->parse(strm);
+				}
+				else
+				{
+					DysonSphere::skip(strm);
+				}
+			}
+		}
+	}
+	sections.endOffset = strm.tellg();
+}
+
+void DysonSphereParser::GameData::parse(InputStream& strm)
+{
+	read(strm, version);
+	if (!dispatchVersion(strm, *this, version, SupportedVersions()))
+		strm.fail("GameData", "version");
+}
+
+template<>
+void DysonSphereParser::GameData::serializeVersion<2>(OutputStream& strm) const
+{
+	write(strm, gameName);
+	gameDesc.serialize(strm);
+	write(strm, gameTick);
+	preferences.serialize(strm);
+	history.serialize(strm);
+	write(strm, hidePlayerModel);
+	write(strm, disableController);
+	statistics.serialize(strm);
+	write(strm, planetId);
+	mainPlayer.serialize(strm);
+	write(strm, factoryCount);
+	galacticTransport.serialize(strm);
+	for (const auto& factory : factories)
+		factory->serialize(strm);
+
+	write(strm, galaxyStarCount);
+	size_t next = 0;
+	for (int32_t i = 0; i < galaxyStarCount; ++i)
+	{
+		const size_t remaining = dysonSpheres.size() - next;
+		if (remaining > 0 && (next < dysonSphereSlot.size() ? dysonSphereSlot[next] == i : isSlotOf(dysonSphereIndex[next], i, galaxyStarCount, remaining)))
+		{
+			write(strm, dysonSphereIndex[next]);
+			dysonSpheres[next].serialize(strm);
+			++next;
+		}
+		else
+		{
+			write(strm, int32_t(0));
+		}
+	}
+}
+
+void DysonSphereParser::GameData::serialize(OutputStream& strm) const
+{
+	write(strm, version);
+	dispatchSerialize(strm, *this, version, SupportedVersions());
+}
+
+void DysonSphereParser::GameData::recordFactories()
+{
+	sections.planetIds.clear();
+	sections.factoryOffsets.clear();
+	sections.factoryLengths.clear();
+	for (const auto& factory : factories)
+	{
+		sections.planetIds.push_back(factory.planetId);
+		sections.factoryOffsets.push_back(factory.offset);
+		sections.factoryLengths.push_back(factory.length);
+	}
+}
+
+// Each PlanetFactory is self-contained, so after a structural pre-scan has found where each one
+// starts they are parsed in parallel, every worker using its own cursor over the mapped file.
+void DysonSphereParser::GameData::parseFactories(InputStream& strm)
+{
+	scanFactories(strm);
+
+	// Start with the biggest factories so that a large one does not end up alone at the end.
+	std::vector<int32_t> order(factories.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](const int32_t a, const int32_t b)
+	{
+		return factories[a].length > factories[b].length;
+	});
+
+	parallelFor(static_cast<int32_t>(order.size()), strm.options().threadCount, [&](const int32_t i)
+	{
+		factories[order[i]].load(strm);
+	});
+
+	// Workers stop on their own cursors.  Only EErrorMode::Report gets here with a failure.
+	for (const auto& factory : factories)
+	{
+		if (factory.failure())
+		{
+			strm.fail(factory.failure());
+			break;
+		}
+	}
+}
+
+// Finds the planet and byte range of every PlanetFactory without building any of them.
+void DysonSphereParser::GameData::scanFactories(InputStream& strm)
+{
+	if (factoryCount > 0 && !strm.checkCount(factoryCount, sizeof(int32_t), "GameData", "factoryCount"))
+		return;
+	factories.resize(std::max(factoryCount, 0));
+	const SectionIndex* const index = strm.sectionIndex();
+	if (index != nullptr)
+	{
+		if (index->planetIds.size() != factories.size())
+		{
+			strm.fail("SectionIndex", "planetIds");
+			return;
+		}
+		for (size_t i = 0; i < factories.size(); ++i)
+		{
+			factories[i].planetId = index->planetIds[i];
+			factories[i].offset = index->factoryOffsets[i];
+			factories[i].length = index->factoryLengths[i];
+		}
+		strm.seekg(index->dysonSpheresOffset);
+		return;
+	}
+
+	for (auto& factory : factories)
+	{
+		factory.offset = strm.tellg();
+		strm.skip(sizeof(int32_t));
+		read(strm, factory.planetId);
+		strm.seekg(factory.offset);
+		PlanetFactory::skip(strm);
+		factory.length = strm.tellg() - factory.offset;
+	}
+	if (!strm)
+		strm.fail("GameData", "factories");
 }
 
 DysonSphereParser::GameSave::GameSave() :
@@ -3003,63 +6255,464 @@ DysonSphereParser::GameSave::GameSave() :
 {
 }
 
-void DysonSphereParser::GameSave::parse(std::ifstream& strm)
+// Reads the fields in front of the screenshot, which GameSave and SaveMetadata share.
+template<typename HEADER>
+void DysonSphereParser::parseHeader(InputStream& strm, HEADER& header)
 {
 	char vfsave[6] = { 0 };
 	strm.read(vfsave, sizeof(vfsave));
 	if (strncmp(vfsave, "VFSAVE", sizeof(vfsave)) != 0)
-	{
-		assert(false);
-		throw std::exception("Unexpected vfsave");
-	}
+		strm.fail("GameSave", "vfsave");
+
+	read(strm, header.fileStreamLength);
+	read(strm, header.saveFileFormatNumber);
+	if (!supportsVersion(header.saveFileFormatNumber, GameSave::SupportedFormats()))
+		strm.fail("GameSave", "saveFileFormatNumber");
+	read(strm, header.majorGameVersion);
+	read(strm, header.minorGameVersion);
+	read(strm, header.releaseGameVersion);
+	read(strm, header.gameTick);
+	read(strm, header.nowTicks);
+	read(strm, header.sizeOfPngFile);
+}
+
+void DysonSphereParser::GameSave::parse(InputStream& strm)
+{
+	parseHeader(strm, *this);
 
-	read(strm, fileStreamLength);
-	read(strm, saveFileFormatNumber);
-	if (saveFileFormatNumber != 4)
+	if (strm.checkCount(sizeOfPngFile, 1, "GameSave", "screenShotPngFile"))
 	{
-		assert(false);
-		throw std::exception("Unexpected saveFileFormatNumber");
+		screenShotPngFile.resize(sizeOfPngFile);
+		strm.read(reinterpret_cast<char*>(screenShotPngFile.data()), sizeOfPngFile);
 	}
-	read(strm, majorGameVersion);
-	read(strm, minorGameVersion);
-	read(strm, releaseGameVersion);
-	read(strm, gameTick);
-	read(strm, nowTicks);
-	read(strm, sizeOfPngFile);
-
-	screenShotPngFile.resize(sizeOfPngFile);
-	strm.read(reinterpret_cast<char*>(screenShotPngFile.data()), sizeOfPngFile);
 
 	data.parse(strm);
 }
 
+void DysonSphereParser::GameSave::serialize(OutputStream& strm) const
+{
+	strm.write("VFSAVE", 6);
+	write(strm, fileStreamLength);
+	write(strm, saveFileFormatNumber);
+	write(strm, majorGameVersion);
+	write(strm, minorGameVersion);
+	write(strm, releaseGameVersion);
+	write(strm, gameTick);
+	write(strm, nowTicks);
+	write(strm, sizeOfPngFile);
+	write(strm, screenShotPngFile);
+	data.serialize(strm);
+}
+
+DysonSphereParser::SaveMetadata::SaveMetadata() :
+	m_readSuccessFlag(false),
+	fileStreamLength(0),
+	saveFileFormatNumber(0),
+	majorGameVersion(0),
+	minorGameVersion(0),
+	releaseGameVersion(0),
+	gameTick(0),
+	nowTicks(0),
+	sizeOfPngFile(0),
+	gameDataVersion(0)
+{
+}
+
+void DysonSphereParser::SaveMetadata::parse(InputStream& strm)
+{
+	parseHeader(strm, *this);
+	strm.skip(sizeOfPngFile);
+
+	read(strm, gameDataVersion);
+	if (!supportsVersion(gameDataVersion, GameData::SupportedVersions()))
+		strm.fail("GameData", "version");
+	read(strm, gameName);
+	gameDesc.parse(strm);
+}
+
 template<typename CHAR>
-DysonSphereParser::DysonSphereParser(const CHAR* const filename) :
+DysonSphereParser::DysonSphereParser(const CHAR* const filename, const EInputMode inputMode) :
 	m_readSuccessFlag(false)
 {
-	std::ifstream strm(filename, std::ios_base::binary);
-	if (!strm)
+	ParseOptions options;
+	options.inputMode = inputMode;
+	load(filename, options);
+}
+
+template<typename CHAR>
+DysonSphereParser::DysonSphereParser(const CHAR* const filename, const ParseOptions& options) :
+	m_readSuccessFlag(false)
+{
+	load(filename, options);
+}
+
+template<typename CHAR>
+void DysonSphereParser::load(const CHAR* const filename, const ParseOptions& options)
+{
+	// Reassigning gameSave inside the scope binds its own members to the arena as well.
+	if (options.useArena)
+		m_arena = std::make_shared<MonotonicArena>();
+	ArenaScope scope(m_arena.get());
+	gameSave = GameSave();
+
+	// The snapshot holds the whole save, so it only stands in for a full parse.
+	const bool useSnapshot = options.useSnapshot && options.projection.isFull() && options.visitor == nullptr;
+	if (useSnapshot)
+	{
+		if (gameSave.loadSnapshot(filename, options))
+		{
+			m_readSuccessFlag = true;
+			return;
+		}
+		gameSave = GameSave();
+	}
+
+	// Held by pointer so that lazy PlanetFactory handles can keep the file open after loading.
+	const auto source = std::make_shared<InputStream>();
+	InputStream& strm = *source;
+	strm.setOptions(options);
+	if (!strm.open(filename, options.inputMode))
 	{
 		m_failureDescription = "Failed to open file";
 		return;
 	}
 
+	SectionIndex index;
+	const bool indexValid = options.useSectionIndex && index.load(filename);
+	if (indexValid)
+		strm.setSectionIndex(&index);
+
 	try
 	{
 		gameSave.parse(strm);
 	}
 	catch (std::exception& e)
 	{
+		strm.setSectionIndex(nullptr);
+		m_failure = strm.failure();
 		m_failureDescription = e.what();
 		return;
 	}
 
+	strm.setSectionIndex(nullptr);
+	m_failure = strm.failure();
+	if (m_failure)
+	{
+		m_failureDescription = m_failure.describe();
+		return;
+	}
 	m_readSuccessFlag = strm.tellg() == gameSave.fileStreamLength;
+	if (m_readSuccessFlag && options.useSectionIndex && !indexValid)
+		gameSave.data.sections.save(filename);
+	if (m_readSuccessFlag && useSnapshot)
+		gameSave.saveSnapshot(filename);
+}
+
+// Only a few hundred bytes at the start of the file and after the screenshot are needed, so the
+// file is read through a small Stream mode buffer rather than mapped.
+template<typename CHAR>
+DysonSphereParser::SaveMetadata DysonSphereParser::scanMetadata(const CHAR* const filename)
+{
+	SaveMetadata metadata;
+	metadata.path = filename;
+
+	// Directory scans meet plenty of broken autosaves, so failures are reported rather than thrown.
+	ParseOptions options;
+	options.streamChunkSize = 4096;
+	options.errorMode = EErrorMode::Report;
+	InputStream strm;
+	strm.setOptions(options);
+	if (!strm.open(filename, EInputMode::Stream))
+	{
+		metadata.m_failureDescription = "Failed to open file";
+		return metadata;
+	}
+
+	metadata.parse(strm);
+	metadata.m_readSuccessFlag = strm.good() && metadata.fileStreamLength == strm.length();
+	if (strm.failure())
+		metadata.m_failureDescription = strm.failure().describe();
+	else if (!metadata.m_readSuccessFlag)
+		metadata.m_failureDescription = "Unexpected end of file";
+	return metadata;
+}
+
+DysonSphereParser::ThumbnailView::ThumbnailView() :
+	m_readSuccessFlag(false),
+	m_data(nullptr),
+	m_size(0),
+	m_offset(0)
+{
+}
+
+template<typename CHAR>
+DysonSphereParser::ThumbnailView DysonSphereParser::readThumbnail(const CHAR* const filename)
+{
+	ThumbnailView thumbnail;
+	const auto source = std::make_shared<InputStream>();
+	if (!source->open(filename, EInputMode::MemoryMapped))
+	{
+		thumbnail.m_failureDescription = "Failed to open file";
+		return thumbnail;
+	}
+
+	SaveMetadata header;
+	try
+	{
+		parseHeader(*source, header);
+	}
+	catch (std::exception& e)
+	{
+		thumbnail.m_failureDescription = e.what();
+		return thumbnail;
+	}
+
+	thumbnail.m_offset = source->tellg();
+	thumbnail.m_size = header.sizeOfPngFile;
+	if (!source->good() || thumbnail.m_size < 0 || thumbnail.m_offset + thumbnail.m_size > source->length())
+	{
+		thumbnail.m_failureDescription = "Unexpected end of file in screenShotPngFile";
+		return thumbnail;
+	}
+
+	thumbnail.m_data = reinterpret_cast<const uint8_t*>(source->view(thumbnail.m_offset, thumbnail.m_size));
+	if (thumbnail.m_data != nullptr)
+		thumbnail.m_source = source;
+	thumbnail.m_readSuccessFlag = true;
+	return thumbnail;
+}
+
+std::vector<DysonSphereParser::SaveMetadata> DysonSphereParser::scanDirectory(const std::filesystem::path& directory, const int32_t threadCount)
+{
+	std::vector<std::filesystem::path> paths;
+	if (std::filesystem::is_directory(directory))
+		paths = findSaves(directory);
+
+	std::vector<SaveMetadata> results(paths.size());
+	parallelFor(static_cast<int32_t>(paths.size()), threadCount, [&](const int32_t i)
+	{
+		results[i] = scanMetadata(paths[i].c_str());
+	});
+	return results;
+}
+
+// Matches name against a file name pattern where * is any run of characters and ? any one character.
+template<typename CHAR>
+static bool matchWildcard(const CHAR* pattern, const CHAR* name)
+{
+	const CHAR* star = nullptr;
+	const CHAR* resume = nullptr;
+	while (*name != 0)
+	{
+		if (*pattern == '*')
+		{
+			star = pattern++;
+			resume = name;
+		}
+		else if (*pattern == '?' || *pattern == *name)
+		{
+			++pattern;
+			++name;
+		}
+		else if (star != nullptr)
+		{
+			pattern = star + 1;
+			name = ++resume;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	while (*pattern == '*')
+		++pattern;
+	return *pattern == 0;
+}
+
+std::vector<std::filesystem::path> DysonSphereParser::findSaves(const std::filesystem::path& input)
+{
+	std::vector<std::filesystem::path> paths;
+	std::error_code error;
+	if (std::filesystem::is_regular_file(input, error))
+	{
+		paths.push_back(input);
+		return paths;
+	}
+
+	const bool isDirectory = std::filesystem::is_directory(input, error);
+	const std::filesystem::path directory = isDirectory ? input : input.parent_path().empty() ? std::filesystem::path(".") : input.parent_path();
+	const std::filesystem::path pattern = input.filename();
+	for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+	{
+		const std::filesystem::path& path = it->path();
+		const bool selected = isDirectory ? path.extension() == ".dsv" : matchWildcard(pattern.c_str(), path.filename().c_str());
+		if (selected && it->is_regular_file(error))
+			paths.push_back(isDirectory || !input.parent_path().empty() ? path : path.filename());
+	}
+	std::sort(paths.begin(), paths.end());
+	return paths;
+}
+
+void DysonSphereParser::parseBatch(const std::vector<std::filesystem::path>& paths, const ParseOptions& options, const BatchCallback& callback, const int32_t threadCount)
+{
+	// This is not work stealing: parallelFor hands out indices in order from one shared counter, so
+	// sorting the files largest first is what balances the threads.  Files which cannot be sized sort
+	// last and still get parsed, to report the failure.
+	std::vector<std::pair<uintmax_t, int32_t>> order(paths.size());
+	for (size_t i = 0; i < paths.size(); ++i)
+	{
+		std::error_code error;
+		const uintmax_t size = std::filesystem::file_size(paths[i], error);
+		order[i] = std::make_pair(error ? 0 : size, static_cast<int32_t>(i));
+	}
+	std::sort(order.begin(), order.end(), [](const std::pair<uintmax_t, int32_t>& a, const std::pair<uintmax_t, int32_t>& b)
+	{
+		return a.first != b.first ? a.first > b.first : a.second < b.second;
+	});
+
+	// The files already keep every thread busy.  Factories parsed in parallel as well would start
+	// threadCount more threads in each worker.
+	ParseOptions fileOptions = options;
+	fileOptions.parallelFactories = false;
+	parallelFor(static_cast<int32_t>(order.size()), threadCount, [&](const int32_t i)
+	{
+		const std::filesystem::path& path = paths[order[i].second];
+		DysonSphereParser parser(path.c_str(), fileOptions);
+		callback(path, parser);
+	});
+}
+
+bool DysonSphereParser::save(const std::filesystem::path& path) const
+{
+	OutputStream strm;
+	if (!strm.open(path))
+		return false;
+	gameSave.serialize(strm);
+	const bool loaded = std::none_of(gameSave.data.factories.begin(), gameSave.data.factories.end(), [](const PlanetFactoryHandle& factory)
+	{
+		return static_cast<bool>(factory.failure());
+	});
+	return strm.close() && loaded;
+}
+
+// Planet ids are star * 100 + planet, so the copies take the free ids of that form from the first star
+// on.  Only the planet ids are made unique: the copies keep the station gids of their seed factory, so
+// the result is meant for the parser, not for the game.
+DysonSphereParser::GameSave DysonSphereParser::synthesize(const GameSave& seed, const int32_t factoryCount)
+{
+	GameSave result = seed;
+	GameData& data = result.data;
+	data.factories.clear();
+	const auto& seedFactories = seed.data.factories;
+	if (!seedFactories.empty())
+	{
+		std::vector<int32_t> usedIds;
+		for (const auto& factory : seedFactories)
+			usedIds.push_back(factory.planetId);
+		std::sort(usedIds.begin(), usedIds.end());
+
+		int32_t nextId = 100;
+		for (int32_t i = 0; i < factoryCount; ++i)
+		{
+			auto factory = std::make_shared<PlanetFactory>(*seedFactories[i % seedFactories.size()]);
+			if (i >= static_cast<int32_t>(seedFactories.size()))
+			{
+				++nextId;
+				while (nextId % 100 == 0 || std::binary_search(usedIds.begin(), usedIds.end(), nextId))
+					++nextId;
+				factory->planetId = nextId;
+				for (auto& station : factory->transport.stationPool)
+					station.planetId = nextId;
+			}
+			data.factories.emplace_back(factory);
+			data.factories.back().planetId = factory->planetId;
+		}
+	}
+	data.factoryCount = static_cast<int32_t>(data.factories.size());
+
+	// One production record per factory, repeated like the factories.
+	const auto& seedStats = seed.data.statistics.production.factoryStatPool;
+	auto& stats = data.statistics.production.factoryStatPool;
+	if (!seedStats.empty())
+	{
+		stats.clear();
+		for (int32_t i = 0; i < data.factoryCount; ++i)
+			stats.push_back(seedStats[i % seedStats.size()]);
+		data.statistics.production.numFactoryStatPool = static_cast<int32_t>(stats.size());
+	}
+
+	OutputStream counter;
+	result.serialize(counter);
+	result.fileStreamLength = counter.tellp();
+	return result;
 }
 
 int main(int argc, char* argv[])
 {
-	DysonSphereParser saveFile(L"specify path to .dsv here, char* or wchar_t*");
+	// The resource report only needs the vein totals of each planet.
+	DysonSphereParser::ParseOptions options;
+	options.inputMode = DysonSphereParser::EInputMode::MemoryMapped;
+	options.projection = DysonSphereParser::Projection(false);
+	options.projection.planet = true;
+	options.projection.factories = true;
+
+	// Writes a save of the given number of factories built from a seed save, for benchmarks.
+	if (argc == 5 && strcmp(argv[1], "--synthesize") == 0)
+	{
+		DysonSphereParser seed(argv[2], DysonSphereParser::EInputMode::MemoryMapped);
+		if (!seed.m_readSuccessFlag)
+		{
+			std::cerr << "ERROR: Failed to parse save file: " << seed.m_failureDescription << std::endl;
+			return 1;
+		}
+		seed.gameSave = DysonSphereParser::synthesize(seed.gameSave, std::stoi(argv[4]));
+		if (!seed.save(argv[3]))
+		{
+			std::cerr << "ERROR: Failed to write " << argv[3] << std::endl;
+			return 1;
+		}
+		std::cout << argv[3] << ": " << seed.gameSave.data.factoryCount << " factories, " << seed.gameSave.fileStreamLength << " bytes" << std::endl;
+		return 0;
+	}
+
+	// Batch mode: every argument is a save, a directory or a wildcard pattern.  Each save gets one
+	// line as soon as it is parsed.  The saves are parsed in full, so that a line without an error
+	// means the whole file decoded, and failures are reported rather than thrown.
+	if (argc > 1)
+	{
+		DysonSphereParser::ParseOptions batchOptions;
+		batchOptions.inputMode = DysonSphereParser::EInputMode::MemoryMapped;
+		batchOptions.errorMode = DysonSphereParser::EErrorMode::Report;
+
+		std::vector<std::filesystem::path> paths;
+		for (int i = 1; i < argc; ++i)
+		{
+			const auto found = DysonSphereParser::findSaves(argv[i]);
+			paths.insert(paths.end(), found.begin(), found.end());
+		}
+
+		std::mutex outputMutex;
+		int32_t failures = 0;
+		DysonSphereParser::parseBatch(paths, batchOptions, [&](const std::filesystem::path& path, DysonSphereParser& saveFile)
+		{
+			std::lock_guard<std::mutex> lock(outputMutex);
+			if (saveFile.m_readSuccessFlag)
+			{
+				std::cout << path.string() << ": " << saveFile.gameSave.data.gameName << ", " << saveFile.gameSave.data.factories.size() << " factories" << std::endl;
+			}
+			else
+			{
+				std::cerr << path.string() << ": ERROR: " << saveFile.m_failureDescription << std::endl;
+				++failures;
+			}
+		});
+
+		if (paths.empty())
+			std::cerr << "ERROR: No save files found" << std::endl;
+		return paths.empty() || failures > 0 ? 1 : 0;
+	}
+
+	DysonSphereParser saveFile(L"specify path to .dsv here, char* or wchar_t*", options);
 
 	if (!saveFile.m_readSuccessFlag)
 	{
@@ -3076,7 +6729,7 @@ int main(int argc, char* argv[])
 
 #if 0
 		std::cout << "  Vein pool:" << std::endl;
-		for (const auto& vein : factory.veinPool)
+		for (const auto& vein : factory->veinPool)
 		{
 			if (vein.id != 0 || vein.amount != 0 || vein.type != DysonSphereParser::EVeinType::None)
 			{
@@ -3086,9 +6739,9 @@ int main(int argc, char* argv[])
 
 		std::cout << "  Vein amounts:" << std::endl;
 #endif
-		for (uint32_t type = 0; type < factory.planet.veinAmounts.size(); ++type)
+		for (uint32_t type = 0; type < factory->planet.veinAmounts.size(); ++type)
 		{
-			const auto amount = factory.planet.veinAmounts[type];
+			const auto amount = factory->planet.veinAmounts[type];
 			if (amount != 0)
 			{
 				if (type == static_cast<uint32_t>(DysonSphereParser::EVeinType::Oil))
@@ -3104,7 +6757,7 @@ int main(int argc, char* argv[])
 
 #if 0
 		std::cout << "  Vein groups:" << std::endl;
-		for (const auto& vein : factory.planet.veinGroups)
+		for (const auto& vein : factory->planet.veinGroups)
 		{
 			std::cout << "    amount=" << vein.amount << ", count=" << vein.count << ", type=" << DysonSphereParser::toString(vein.type) << std::endl;
 		}
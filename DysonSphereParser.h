@@ -9,22 +9,380 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cinttypes>
+#include <cstring>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <map>
 #include <fstream>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+// Save files are little endian.  Big endian hosts byte-swap every value after reading it.
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define DSP_BIG_ENDIAN_HOST 1
+#else
+#define DSP_BIG_ENDIAN_HOST 0
+#endif
 
 const float oilSpeedMultiplier = 4E-05f;
 
 class DysonSphereParser
 {
 public:
+    // ReadAhead is Stream with a background thread which reads the next chunk while the current one
+    // is decoded, so slow disks and network shares are read and decoded at the same time.
+    enum class EInputMode { Stream, MemoryMapped, ReadAhead };
+
+    // Throw stops at the first malformed field with an exception.  Report records the failure on the
+    // stream, which then reads as zeros so that the parse returns through ordinary returns.
+    enum class EErrorMode { Throw, Report };
+
+    // Which parts of a save are parsed.  Unselected members are skipped on disk and left empty.
+    class Projection
+    {
+    public:
+        Projection(const bool selected = true);
+        bool isFull() const;  // Every member is selected.
+
+        // PlanetFactory members
+        bool planet;
+        bool entities;  // entityPool, entityAnimPool, entitySignPool, entityConnPool, entityRecycle
+        bool prebuilds;
+        bool vegetation;
+        bool veins;  // veinPool, veinRecycle, veinAnimPool
+        bool cargoContainer;
+        bool cargoTraffic;
+        bool factoryStorage;
+        bool powerSystem;
+        bool factorySystem;
+        bool transport;
+        bool monsterSystem;
+        bool platformSystem;
+
+        // GameData members.  Without a valid SectionIndex, statistics and mainPlayer are still walked
+        // as they have no structural skip().
+        bool statistics;
+        bool mainPlayer;
+        bool factories;
+        bool dysonSpheres;
+    };
+
+    class ParseVisitor;
+
+    class ParseOptions
+    {
+    public:
+        ParseOptions();
+
+        EInputMode inputMode;
+        bool parallelFactories;  // Only used with EInputMode::MemoryMapped, which allows independent cursors.
+        int32_t threadCount;  // Zero uses one thread per hardware thread.
+        bool lazyFactories;  // PlanetFactories are parsed on first access.  The file stays open while a handle refers to it.
+        int32_t streamChunkSize;  // Bytes read from the file at a time in Stream and ReadAhead mode.
+        Projection projection;
+        bool useSectionIndex;  // Seeks with the SectionIndex sidecar next to the save, and writes it when it is missing or stale.
+        bool buildEntityTable;  // Fills PlanetFactory::entityTable as well as entityPool.
+        bool buildEntityIndex;  // Fills PlanetFactory::entityIndex after each factory is parsed.
+        // Pools are allocated from an arena owned by the parser.  They must not be moved out of it.  Every
+        // factory has an arena of its own, so different factories may be changed on different threads.  A
+        // factory parsed from the save keeps its arena in its PlanetFactoryHandle, which release() frees.
+        // Anything which grows a pool after the parse, like rebuilding entityIndex, allocates from that
+        // arena again, and the old storage is only released with the factory.
+        bool useArena;
+        EErrorMode errorMode;
+        bool useSnapshot;  // Loads the snapshot sidecar next to the save when it is current, and writes it after a full parse otherwise.
+        ParseVisitor* visitor;  // Receives the visited pools record by record instead of storing them.  Not owned.
+    };
+
+    // Where a parse stopped.  className and field are null when the file ended early.
+    class ParseFailure
+    {
+    public:
+        ParseFailure();
+        explicit operator bool() const { return offset >= 0; }
+        std::string describe() const;
+
+        const char* className;
+        const char* field;
+        int64_t offset;
+    };
+
+    class SectionIndex;
+
+    // Byte cursor over the save file.  In MemoryMapped mode the cursor walks the mapped file directly.
+    // In Stream mode it walks a chunk buffer which is refilled from the file as it is consumed.
+    class InputStream : public std::enable_shared_from_this<InputStream>
+    {
+    public:
+        InputStream();
+        ~InputStream();
+        InputStream(const InputStream&) = delete;
+        InputStream& operator=(const InputStream&) = delete;
+
+        bool open(const char* const filename, const EInputMode mode);
+        bool open(const wchar_t* const filename, const EInputMode mode);
+        void attach(const InputStream& source, const int64_t position);
+        void close();
+
+        void read(char* const buffer, const int64_t count)
+        {
+            if (count == 0)
+                return;  // The buffer may be the null data() of an empty vector.
+            if (m_end - m_cursor >= count)
+            {
+                memcpy(buffer, m_cursor, static_cast<size_t>(count));
+                m_cursor += count;
+            }
+            else
+            {
+                readSlow(buffer, count);
+            }
+        }
+
+        int64_t tellg() const
+        {
+            return m_failed ? -1 : m_chunkOffset + (m_cursor - m_begin);
+        }
+
+        void skip(const int64_t count)
+        {
+            if (count >= 0 && m_end - m_cursor >= count)
+                m_cursor += count;
+            else
+                skipSlow(count);
+        }
+
+        void seekg(const int64_t position);
+        const char* view(const int64_t position, const int64_t count) const;  // Null unless MemoryMapped.
+        int64_t length() const { return m_length; }
+        EInputMode mode() const { return m_mode; }
+        bool good() const { return !m_failed; }
+        explicit operator bool() const { return !m_failed; }
+
+        // Records the first malformed field at the current offset and stops the stream, after which
+        // every read returns zeros.  Throws as well in EErrorMode::Throw.
+        void fail(const char* const className, const char* const field);
+        void fail(const ParseFailure& failure);  // Adopts the failure of another cursor.
+        const ParseFailure& failure() const { return m_failure; }
+        void recover();  // Clears the failure of a shared source once a reader has taken it over.
+
+        // Fails unless count elements of at least elementSize bytes each fit in the rest of the file,
+        // so that a corrupt count never turns into a huge allocation.  A stopped stream has no bytes left.
+        bool checkCount(const int64_t count, const int64_t elementSize, const char* const className, const char* const field)
+        {
+            if (count == 0 || (count > 0 && !m_failed && count <= (m_length - tellg()) / elementSize))
+                return true;
+            fail(className, field);
+            return false;
+        }
+
+        const ParseOptions& options() const { return m_options; }
+        void setOptions(const ParseOptions& options) { m_options = options; }
+        const SectionIndex* sectionIndex() const { return m_sectionIndex; }
+        void setSectionIndex(const SectionIndex* const index) { m_sectionIndex = index; }
+
+        // Serializes cursor moves when several readers share one Stream mode source.
+        std::mutex& mutex() { return m_mutex; }
+
+    private:
+        void readSlow(char* buffer, int64_t count);
+        void skipSlow(const int64_t count);
+        bool openMapping();
+        bool openStream(const EInputMode mode);
+        void fill();
+        void readAhead();
+        void stop();
+
+        EInputMode m_mode;
+        std::ifstream m_file;
+        std::vector<char> m_chunk;
+        std::vector<char> m_nextChunk;  // ReadAhead: filled by m_reader while m_chunk is decoded.
+        int64_t m_nextSize;
+        bool m_nextPending;  // m_reader owns m_file and m_nextChunk until this is false again.
+        bool m_stopReader;
+        std::mutex m_readerMutex;
+        std::condition_variable m_readerSignal;
+        std::thread m_reader;
+        const char* m_begin;
+        const char* m_cursor;
+        const char* m_end;
+        int64_t m_chunkOffset;
+        int64_t m_length;
+        bool m_failed;
+        ParseFailure m_failure;
+        ParseOptions m_options;
+        const SectionIndex* m_sectionIndex;
+        std::mutex m_mutex;
+        void* m_mappedView;
+#ifdef _WIN32
+        void* m_fileHandle;
+        void* m_mappingHandle;
+#else
+        int m_fileDescriptor;
+#endif
+    };
+
+    // Byte sink for the writer.  Writes are gathered in a chunk buffer which goes to the file whenever it
+    // fills up.  A stream which was never opened only counts, so a save can be measured before it is written.
+    class OutputStream
+    {
+    public:
+        OutputStream();
+        ~OutputStream();
+        OutputStream(const OutputStream&) = delete;
+        OutputStream& operator=(const OutputStream&) = delete;
+
+        bool open(const std::filesystem::path& path);
+        bool close();  // Flushes the chunk.  False when anything failed since open().
+
+        void write(const char* const buffer, const int64_t count)
+        {
+            if (count == 0)
+                return;  // As in InputStream::read().
+            if (m_end - m_cursor >= count)
+            {
+                memcpy(m_cursor, buffer, static_cast<size_t>(count));
+                m_cursor += count;
+            }
+            else
+            {
+                writeSlow(buffer, count);
+            }
+        }
+
+        int64_t tellp() const
+        {
+            return m_chunkOffset + (m_cursor - m_chunk.data());
+        }
+
+        void fail() { m_failed = true; }  // Marks data which cannot be written, such as an unsupported version.
+        bool good() const { return !m_failed; }
+
+    private:
+        static const size_t chunkSize = 1024 * 1024;
+
+        void writeSlow(const char* buffer, int64_t count);
+        void flush();
+
+        std::ofstream m_file;
+        std::vector<char> m_chunk;
+        char* m_cursor;
+        char* m_end;
+        int64_t m_chunkOffset;
+        bool m_failed;
+    };
+
+    // Bump allocator for the parsed pools.  While an ArenaScope is active on a thread, every Vector
+    // created on that thread allocates from the arena.  Nothing is freed until the arena itself is
+    // destroyed, which releases everything in a few large blocks.
+    class MonotonicArena
+    {
+    public:
+        MonotonicArena();
+        MonotonicArena(const MonotonicArena&) = delete;
+        MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+        void* allocate(const size_t bytes, const size_t alignment);
+        MonotonicArena* createChild();  // Thread-safe.  For a worker thread, released with this arena.
+        int64_t bytesAllocated() const;
+
+        static MonotonicArena* current();
+        static MonotonicArena* createCurrentChild();  // A child of the current arena, null when there is none.
+
+    private:
+        friend class ArenaScope;
+
+        static const size_t initialBlockSize = 64 * 1024;
+        static const size_t maximumBlockSize = 16 * 1024 * 1024;
+
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        char* m_cursor;
+        char* m_end;
+        size_t m_nextBlockSize;
+        int64_t m_bytesAllocated;
+        std::vector<std::unique_ptr<MonotonicArena>> m_children;
+        mutable std::mutex m_childrenMutex;
+    };
+
+    // Makes arena the current arena of the calling thread for the lifetime of the scope.  Null selects the heap.
+    class ArenaScope
+    {
+    public:
+        explicit ArenaScope(MonotonicArena* const arena);
+        ~ArenaScope();
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+    private:
+        MonotonicArena* m_previous;
+    };
+
+    // Binds to the current arena of the thread which constructs the container, or to the heap when
+    // there is none.  Copies bind to the current arena of the copying thread.
+    template<typename TYPE>
+    class ArenaAllocator
+    {
+    public:
+        typedef TYPE value_type;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        ArenaAllocator() : m_arena(MonotonicArena::current()) {}
+
+        template<typename OTHER>
+        ArenaAllocator(const ArenaAllocator<OTHER>& other) : m_arena(other.arena()) {}
+
+        TYPE* allocate(const size_t count)
+        {
+            if (m_arena == nullptr)
+                return std::allocator<TYPE>().allocate(count);
+            return static_cast<TYPE*>(m_arena->allocate(count * sizeof(TYPE), alignof(TYPE)));
+        }
+
+        void deallocate(TYPE* const pointer, const size_t count)
+        {
+            if (m_arena == nullptr)
+                std::allocator<TYPE>().deallocate(pointer, count);
+        }
+
+        ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+
+        MonotonicArena* arena() const { return m_arena; }
+
+        template<typename OTHER>
+        bool operator==(const ArenaAllocator<OTHER>& other) const { return m_arena == other.arena(); }
+
+        template<typename OTHER>
+        bool operator!=(const ArenaAllocator<OTHER>& other) const { return m_arena != other.arena(); }
+
+    private:
+        MonotonicArena* m_arena;
+    };
+
+    template<typename TYPE>
+    using Vector = std::vector<TYPE, ArenaAllocator<TYPE>>;
+
+    // The save format versions a class can decode.  parse() reads the version and calls the matching
+    // parseVersion<VERSION>() specialization, so several game patches are decoded by one binary and
+    // supporting a new one means adding its version here and specializing parseVersion for it.
+    template<int32_t... VERSIONS>
+    struct Versions
+    {
+    };
+
     class IntVector2
     {
     public:
         IntVector2();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         int32_t x;
         int32_t y;
@@ -34,7 +392,8 @@ public:
     {
     public:
         Vector3();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         float x;
         float y;
@@ -45,7 +404,8 @@ public:
     {
     public:
         VectorLF3();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         double x;
         double y;
@@ -56,7 +416,8 @@ public:
     {
     public:
         Quaternion();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         float x;
         float y;
@@ -68,7 +429,8 @@ public:
     {
     public:
         GameDesc();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         int32_t version;
         int32_t galaxyAlgo;
@@ -77,14 +439,15 @@ public:
         int32_t playerProto;
         float resourceMultiplier;
         int32_t numThemeIds;
-        std::vector<int32_t> themeIds;
+        Vector<int32_t> themeIds;
     };
 
     class GamePrefsData
     {
     public:
         GamePrefsData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         int32_t version;
         VectorLF3 cameraUPos;
@@ -98,14 +461,15 @@ public:
         bool detailSign;
         bool detailIcon;
         int32_t numTutorialShowing;
-        std::vector<int32_t> tutorialShowing;
+        Vector<int32_t> tutorialShowing;
     };
 
     class TechState
     {
     public:
         TechState();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         int32_t techProtoIndex;
         bool unlocked;
@@ -119,21 +483,27 @@ public:
     {
     public:
         GameHistoryData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<2> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
 
         int32_t version;
         int32_t numRecipeUnlocked;
-        std::vector<int32_t> recipeUnlocked;
+        Vector<int32_t> recipeUnlocked;
         int32_t numTutorialUnlocked;
-        std::vector<int32_t> tutorialUnlocked;
+        Vector<int32_t> tutorialUnlocked;
         int32_t numFeatureKeys;
-        std::vector<int32_t> featureKeys;
+        Vector<int32_t> featureKeys;
         int32_t numTechState;
-        std::vector<TechState> techStates;
+        Vector<TechState> techStates;
         bool autoManageLabItems;
         int32_t currentTech;
         int32_t numTechQueue;
-        std::vector<int32_t> techQueue;
+        Vector<int32_t> techQueue;
         int32_t universeObserveLevel;
         float solarSailLife;
         float solarEnergyLossRate;
@@ -161,15 +531,16 @@ public:
     {
     public:
         ProductStat();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         int32_t version;
         int32_t numCount;
-        std::vector<int32_t> count;
+        Vector<int32_t> count;
         int32_t numCursor;
-        std::vector<int32_t> cursor;
+        Vector<int32_t> cursor;
         int32_t numTotal;
-        std::vector<int32_t> total;
+        Vector<int32_t> total;
         int32_t itemId;
     };
 
@@ -177,15 +548,16 @@ public:
     {
     public:
         PowerStat();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         int32_t version;
         int32_t numEnergy;
-        std::vector<int64_t> energy;
+        Vector<int64_t> energy;
         int32_t numCursor;
-        std::vector<int32_t> cursor;
+        Vector<int32_t> cursor;
         int32_t numTotal;
-        std::vector<int64_t> total;
+        Vector<int64_t> total;
         int32_t itemId;
     };
 
@@ -193,16 +565,22 @@ public:
     {
     public:
         FactoryProductionStat();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<1> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
 
         int32_t version;
         int32_t productCapacity;
         int32_t productCursor;
-        std::vector<ProductStat> productPool;
+        Vector<ProductStat> productPool;
         int32_t numPowerPool;
-        std::vector<PowerStat> powerPool;
+        Vector<PowerStat> powerPool;
         int32_t numProductIndices;
-        std::vector<int32_t> productIndices;
+        Vector<int32_t> productIndices;
         int64_t energyConsumption;
     };
 
@@ -210,26 +588,38 @@ public:
     {
     public:
         ProductionStatistics();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
 
         int32_t version;
         int32_t numFactoryStatPool;
-        std::vector<FactoryProductionStat> factoryStatPool;
+        Vector<FactoryProductionStat> factoryStatPool;
         int32_t numFirstCreateIds;
-        std::vector<int32_t> firstCreateIds;
+        Vector<int32_t> firstCreateIds;
         int32_t numFavoriteIds;
-        std::vector<int32_t> favoriteIds;
+        Vector<int32_t> favoriteIds;
     };
 
     class GameStatData
     {
     public:
         GameStatData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
 
         int32_t version;
         int32_t numTechHashedHistory;
-        std::vector<int32_t> techHashedHistory;
+        Vector<int32_t> techHashedHistory;
         ProductionStatistics production;
     };
 
@@ -237,7 +627,14 @@ public:
     {
     public:
         StorageComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<1> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         struct GRID
         {
@@ -258,14 +655,20 @@ public:
         EStorageType type;
         int32_t gridSize;
         int32_t bans;
-        std::vector<GRID> grids;
+        Vector<GRID> grids;
     };
 
     class ForgeTask
     {
     public:
         ForgeTask();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
 
         int32_t version;
         int32_t recipeId;
@@ -274,12 +677,12 @@ public:
         int32_t tickSpend;
         int32_t numItem;
         int32_t numProduct;
-        std::vector<int32_t> itemIds;
-        std::vector<int32_t> itemCounts;
-        std::vector<int32_t> served;
-        std::vector<int32_t> productIds;
-        std::vector<int32_t> productCounts;
-        std::vector<int32_t> produced;
+        Vector<int32_t> itemIds;
+        Vector<int32_t> itemCounts;
+        Vector<int32_t> served;
+        Vector<int32_t> productIds;
+        Vector<int32_t> productCounts;
+        Vector<int32_t> produced;
         int32_t parentTaskIndex;
     };
 
@@ -287,18 +690,25 @@ public:
     {
     public:
         MechaForge();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
 
         int32_t version;
         int32_t numTasks;
-        std::vector<ForgeTask> tasks;
+        Vector<ForgeTask> tasks;
     };
 
     class MechaLab
     {
     public:
         MechaLab();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         int32_t version;
         int32_t numItemPoints;
@@ -309,7 +719,8 @@ public:
     {
     public:
         MechaDrone();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         int32_t version;
         int32_t stage;
@@ -327,7 +738,13 @@ public:
     {
     public:
         Mecha();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
 
         int32_t version;
         double coreEnergyCap;
@@ -362,14 +779,15 @@ public:
         int32_t droneCount;
         float droneSpeed;
         int32_t droneMovement;
-        std::vector<MechaDrone> drones;
+        Vector<MechaDrone> drones;
     };
 
     class PlayerNavigation
     {
     public:
         PlayerNavigation();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         int32_t version;
         bool navigating;
@@ -390,7 +808,13 @@ public:
     {
     public:
         Player();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<1> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
 
         int32_t version;
         int32_t planetId;
@@ -414,7 +838,8 @@ public:
     {
     public:
         GalacticTransport();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
 
         int32_t version;
     };
@@ -448,7 +873,10 @@ public:
     {
     public:
         VeinGroup();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 28;
 
         EVeinType type;
         Vector3 pos;
@@ -460,21 +888,26 @@ public:
     {
     public:
         PlanetData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t modDataByteCount;
-        std::vector<uint8_t> modData;
+        Vector<uint8_t> modData;
         int32_t numVeinAmounts;
-        std::vector<int64_t> veinAmounts;  // The index is the EVeinType.  This contains the total of the veinGroups's amounts which is also the total of the VeinData::amounts.
+        Vector<int64_t> veinAmounts;  // The index is the EVeinType.  This contains the total of the veinGroups's amounts which is also the total of the VeinData::amounts.
         int32_t numVeinGroups;
-        std::vector<VeinGroup> veinGroups;
+        Vector<VeinGroup> veinGroups;
     };
 
     class EntityData
     {
     public:
         EntityData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 109;
 
         uint8_t version;
         int32_t id;
@@ -502,11 +935,75 @@ public:
         int32_t monsterId;
     };
 
+    // Columnar copy of PlanetFactory::entityPool with one array per field, for scans which read a few
+    // fields of every entity.  Row i holds entityPool[i].
+    class EntityTable
+    {
+    public:
+        EntityTable();
+        void build(const Vector<EntityData>& entities);
+        void clear();
+
+        int32_t size() const { return static_cast<int32_t>(id.size()); }
+        std::vector<int32_t> countByProto() const;  // Indexed by protoId.
+
+        // Calls function(row) for every entity of the given proto.
+        template<typename FUNCTION>
+        void forEachProto(const int16_t proto, FUNCTION function) const
+        {
+            const int32_t count = size();
+            for (int32_t row = 0; row < count; ++row)
+            {
+                if (protoId[row] == proto)
+                    function(row);
+            }
+        }
+
+        // Calls function(row, componentId) for every entity with a component in column, e.g. assemblerId.
+        template<typename FUNCTION>
+        static void forEachComponent(const Vector<int32_t>& column, FUNCTION function)
+        {
+            const int32_t count = static_cast<int32_t>(column.size());
+            for (int32_t row = 0; row < count; ++row)
+            {
+                if (column[row] != 0)
+                    function(row, column[row]);
+            }
+        }
+
+        Vector<int32_t> id;
+        Vector<int16_t> protoId;
+        Vector<int16_t> modelIndex;
+        Vector<Vector3> pos;
+        Vector<Quaternion> rot;
+        Vector<int32_t> beltId;
+        Vector<int32_t> splitterId;
+        Vector<int32_t> storageId;
+        Vector<int32_t> tankId;
+        Vector<int32_t> minerId;
+        Vector<int32_t> inserterId;
+        Vector<int32_t> assemblerId;
+        Vector<int32_t> fractionateId;
+        Vector<int32_t> ejectorId;
+        Vector<int32_t> siloId;
+        Vector<int32_t> labId;
+        Vector<int32_t> stationId;
+        Vector<int32_t> powerNodeId;
+        Vector<int32_t> powerGenId;
+        Vector<int32_t> powerConId;
+        Vector<int32_t> powerAccId;
+        Vector<int32_t> powerExcId;
+        Vector<int32_t> monsterId;
+    };
+
     class AnimData
     {
     public:
         AnimData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 20;
 
         float time;
         float prepare_length;
@@ -519,7 +1016,10 @@ public:
     {
     public:
         SignData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 56;
 
         uint32_t signType;
         uint32_t iconType;
@@ -541,7 +1041,9 @@ public:
     {
     public:
         PrebuildData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         uint8_t version;
         int32_t id;
@@ -557,14 +1059,17 @@ public:
         int32_t recipeId;
         int32_t filterId;
         int32_t refCount;
-        std::vector<int32_t> refArr;
+        Vector<int32_t> refArr;
     };
 
     class VegeData
     {
     public:
         VegeData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 51;
 
         uint8_t version;
         int32_t id;
@@ -580,7 +1085,10 @@ public:
     {
     public:
         VeinData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 51;
 
         uint8_t version;
         int32_t id;
@@ -601,7 +1109,10 @@ public:
     {
     public:
         Cargo();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 32;
 
         int32_t item;
         Vector3 position;
@@ -612,22 +1123,32 @@ public:
     {
     public:
         CargoContainer();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t poolCapacity;
         int32_t cursor;
         int32_t recycleBegin;
         int32_t recycleEnd;
-        std::vector<Cargo> cargoPool;
-        std::vector<int32_t> recycleIds;
+        Vector<Cargo> cargoPool;
+        Vector<int32_t> recycleIds;
     };
 
     class BeltComponent
     {
     public:
         BeltComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 48;
 
         int32_t version;
         int32_t id;
@@ -647,7 +1168,10 @@ public:
     {
     public:
         SplitterComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 66;
 
         int32_t version;
         int32_t id;
@@ -673,7 +1197,14 @@ public:
     {
     public:
         CargoPath();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t id;
@@ -687,19 +1218,26 @@ public:
         int32_t outputIndex;
         int32_t numBelts;
         int32_t numInputPaths;
-        std::vector<uint8_t> buffer;
-        std::vector<int32_t> chunks;
-        std::vector<Vector3> pointPos;
-        std::vector<Quaternion> pointRot;
-        std::vector<int32_t> belts;
-        std::vector<int32_t> inputPaths;
+        Vector<uint8_t> buffer;
+        Vector<int32_t> chunks;
+        Vector<Vector3> pointPos;
+        Vector<Quaternion> pointRot;
+        Vector<int32_t> belts;
+        Vector<int32_t> inputPaths;
     };
 
     class CargoTraffic
     {
     public:
         CargoTraffic();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t beltCursor;
@@ -711,20 +1249,23 @@ public:
         int32_t pathCursor;
         int32_t pathCapacity;
         int32_t pathRecycleCursor;
-        std::vector<BeltComponent> beltPool;
-        std::vector<int32_t> beltRecycle;
-        std::vector<SplitterComponent> splitterPool;
-        std::vector<int32_t> splitterRecycle;
-        std::vector<int32_t> cargoPathIndex;
-        std::vector<CargoPath> pathPool;
-        std::vector<int32_t> pathRecycle;
+        Vector<BeltComponent> beltPool;
+        Vector<int32_t> beltRecycle;
+        Vector<SplitterComponent> splitterPool;
+        Vector<int32_t> splitterRecycle;
+        Vector<int32_t> cargoPathIndex;
+        Vector<CargoPath> pathPool;
+        Vector<int32_t> pathRecycle;
     };
 
     class TankComponent
     {
     public:
         TankComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 55;
 
         int32_t version;
         int32_t id;
@@ -751,28 +1292,38 @@ public:
     {
     public:
         FactoryStorage();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t storageCursor;
         int32_t storageCapacity;
         int32_t storageRecycleCursor;
-        std::vector<int32_t> storagePoolIndex;
-        std::vector<int32_t> storagePoolSize;
-        std::vector<StorageComponent> storagePool;
-        std::vector<int32_t> storageRecycle;
+        Vector<int32_t> storagePoolIndex;
+        Vector<int32_t> storagePoolSize;
+        Vector<StorageComponent> storagePool;
+        Vector<int32_t> storageRecycle;
         int32_t tankCapacity;
         int32_t tankCursor;
         int32_t tankRecycleCursor;
-        std::vector<TankComponent> tankPool;
-        std::vector<int32_t> tankRecycle;
+        Vector<TankComponent> tankPool;
+        Vector<int32_t> tankRecycle;
     };
 
     class PowerGeneratorComponent
     {
     public:
         PowerGeneratorComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 103;
 
         int32_t version;
         int32_t id;
@@ -805,7 +1356,10 @@ public:
     {
     public:
         PowerNodeComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 49;
 
         int32_t version;
         int32_t id;
@@ -824,7 +1378,10 @@ public:
     {
     public:
         PowerConsumerComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 60;
 
         int32_t version;
         int32_t id;
@@ -841,7 +1398,10 @@ public:
     {
     public:
         PowerAccumulatorComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 48;
 
         int32_t version;
         int32_t id;
@@ -857,7 +1417,10 @@ public:
     {
     public:
         PowerExchangerComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 96;
 
         int32_t version;
         int32_t id;
@@ -890,7 +1453,9 @@ public:
     {
     public:
         PowerNetworkStructures_Node();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t id;
@@ -905,16 +1470,23 @@ public:
         int32_t numConnIdsForLoad;
         int32_t numLineIdsForLoad;
         int32_t numConsumers;
-        std::vector<int32_t> connIdsForLoad;
-        std::vector<int32_t> lineIdsForLoad;
-        std::vector<int32_t> consumers;
+        Vector<int32_t> connIdsForLoad;
+        Vector<int32_t> lineIdsForLoad;
+        Vector<int32_t> consumers;
     };
 
     class PowerNetwork
     {
     public:
         PowerNetwork();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t id;
@@ -923,58 +1495,67 @@ public:
         int32_t numGenerators;
         int32_t numAccumulators;
         int32_t numExchangers;
-        std::vector<PowerNetworkStructures_Node> nodes;
-        std::vector<int32_t> consumers;
-        std::vector<int32_t> generators;
-        std::vector<int32_t> accumulators;
-        std::vector<int32_t> exchangers;
+        Vector<PowerNetworkStructures_Node> nodes;
+        Vector<int32_t> consumers;
+        Vector<int32_t> generators;
+        Vector<int32_t> accumulators;
+        Vector<int32_t> exchangers;
     };
 
     class PowerSystem
     {
     public:
         PowerSystem();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t generatorCapacity;
         int32_t genCursor;
         int32_t genRecycleCursor;
-        std::vector<PowerGeneratorComponent> genPool;
-        std::vector<int32_t> genRecycle;
+        Vector<PowerGeneratorComponent> genPool;
+        Vector<int32_t> genRecycle;
         int32_t nodeCapacity;
         int32_t nodeCursor;
         int32_t nodeRecycleCursor;
-        std::vector<PowerNodeComponent> nodePool;
-        std::vector<int32_t> nodeRecycle;
+        Vector<PowerNodeComponent> nodePool;
+        Vector<int32_t> nodeRecycle;
         int32_t consumerCapacity;
         int32_t consumerCursor;
         int32_t consumerRecycleCursor;
-        std::vector<PowerConsumerComponent> consumerPool;
-        std::vector<int32_t> consumerRecycle;
+        Vector<PowerConsumerComponent> consumerPool;
+        Vector<int32_t> consumerRecycle;
         int32_t accumulatorCapacity;
         int32_t accCursor;
         int32_t accRecycleCursor;
-        std::vector<PowerAccumulatorComponent> accPool;
-        std::vector<int32_t> accRecycle;
+        Vector<PowerAccumulatorComponent> accPool;
+        Vector<int32_t> accRecycle;
         int32_t exchangerCapacity;
         int32_t excCursor;
         int32_t excRecycleCursor;
-        std::vector<PowerExchangerComponent> excPool;
-        std::vector<int32_t> excRecycle;
+        Vector<PowerExchangerComponent> excPool;
+        Vector<int32_t> excRecycle;
         int32_t networkCapacity;
         int32_t netCursor;
         int32_t netRecycleCursor;
-        std::vector<int32_t> powerNetworkIncludedFlag;
-        std::vector<PowerNetwork> netPool;
-        std::vector<int32_t> netRecycle;
+        Vector<int32_t> powerNetworkIncludedFlag;
+        Vector<PowerNetwork> netPool;
+        Vector<int32_t> netRecycle;
     };
 
     class MinerComponent
     {
     public:
         MinerComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t id;
@@ -989,7 +1570,7 @@ public:
         enum class EWorkState { Idle, Running, Outputing, Lack, Full };
         EWorkState workstate;
         int32_t veinCount;
-        std::vector<int32_t> veins;
+        Vector<int32_t> veins;
         int32_t currentVeinIndex;
         int32_t minimumVeinAmount;
         int32_t productId;
@@ -1001,7 +1582,10 @@ public:
     {
     public:
         InserterComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 98;
 
         int32_t version;
         int32_t id;
@@ -1033,7 +1617,14 @@ public:
     {
     public:
         AssemblerComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t id;
@@ -1048,26 +1639,29 @@ public:
         ERecipeType recipeType;
         int32_t timeSpend;
         int32_t numRequires;
-        std::vector<int32_t> requires;
+        Vector<int32_t> requires;
         int32_t numRequireCounts;
-        std::vector<int32_t> requireCounts;
+        Vector<int32_t> requireCounts;
         int32_t numServed;
-        std::vector<int32_t> served;
+        Vector<int32_t> served;
         int32_t numNeeds;
-        std::vector<int32_t> needs;
+        Vector<int32_t> needs;
         int32_t numProducts;
-        std::vector<int32_t> products;
+        Vector<int32_t> products;
         int32_t numProductCounts;
-        std::vector<int32_t> productCounts;
+        Vector<int32_t> productCounts;
         int32_t numProduced;
-        std::vector<int32_t> produced;
+        Vector<int32_t> produced;
     };
 
     class FractionateComponent
     {
     public:
         FractionateComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 78;
 
         int32_t version;
         int32_t id;
@@ -1099,7 +1693,10 @@ public:
     {
     public:
         EjectorComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 101;
 
         int32_t version;
         int32_t id;
@@ -1126,7 +1723,10 @@ public:
     {
     public:
         SiloComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 78;
 
         int32_t version;
         int32_t id;
@@ -1150,7 +1750,14 @@ public:
     {
     public:
         LabComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t id;
@@ -1166,74 +1773,84 @@ public:
         int32_t techId;
         int32_t timeSpend;
         int32_t numRequires;
-        std::vector<int32_t> requires;
+        Vector<int32_t> requires;
         int32_t numRequireCounts;
-        std::vector<int32_t> requireCounts;
+        Vector<int32_t> requireCounts;
         int32_t numServed;
-        std::vector<int32_t> served;
+        Vector<int32_t> served;
         int32_t numNeeds;
-        std::vector<int32_t> needs;
+        Vector<int32_t> needs;
         int32_t numProducts;
-        std::vector<int32_t> products;
+        Vector<int32_t> products;
         int32_t numProductCounts;
-        std::vector<int32_t> productCounts;
+        Vector<int32_t> productCounts;
         int32_t numProduced;
-        std::vector<int32_t> produced;
+        Vector<int32_t> produced;
         int32_t numMatrixPoints;
-        std::vector<int32_t> matrixPoints;
+        Vector<int32_t> matrixPoints;
         int32_t numMatrixServed;
-        std::vector<int32_t> matrixServed;
+        Vector<int32_t> matrixServed;
     };
 
     class FactorySystem
     {
     public:
         FactorySystem();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t minerCapacity;
         int32_t minerCursor;
         int32_t minerRecycleCursor;
-        std::vector<MinerComponent> minerPool;
-        std::vector<int32_t> minerRecycle;
+        Vector<MinerComponent> minerPool;
+        Vector<int32_t> minerRecycle;
         int32_t inserterCapacity;
         int32_t inserterCursor;
         int32_t inserterRecycleCursor;
-        std::vector<InserterComponent> inserterPool;
-        std::vector<int32_t> inserterRecycle;
+        Vector<InserterComponent> inserterPool;
+        Vector<int32_t> inserterRecycle;
         int32_t assemblerCapacity;
         int32_t assemblerCursor;
         int32_t assemblerRecycleCursor;
-        std::vector<AssemblerComponent> assemblerPool;
-        std::vector<int32_t> assemblerRecycle;
+        Vector<AssemblerComponent> assemblerPool;
+        Vector<int32_t> assemblerRecycle;
         int32_t fractionateCapacity;
         int32_t fractionateCursor;
         int32_t fractionateRecycleCursor;
-        std::vector<FractionateComponent> fractionatePool;
-        std::vector<int32_t> fractionateRecycle;
+        Vector<FractionateComponent> fractionatePool;
+        Vector<int32_t> fractionateRecycle;
         int32_t ejectorCapacity;
         int32_t ejectorCursor;
         int32_t ejectorRecycleCursor;
-        std::vector<EjectorComponent> ejectorPool;
-        std::vector<int32_t> ejectorRecycle;
+        Vector<EjectorComponent> ejectorPool;
+        Vector<int32_t> ejectorRecycle;
         int32_t siloCapacity;
         int32_t siloCursor;
         int32_t siloRecycleCursor;
-        std::vector<SiloComponent> siloPool;
-        std::vector<int32_t> siloRecycle;
+        Vector<SiloComponent> siloPool;
+        Vector<int32_t> siloRecycle;
         int32_t labCapacity;
         int32_t labCursor;
         int32_t labRecycleCursor;
-        std::vector<LabComponent> labPool;
-        std::vector<int32_t> labRecycle;
+        Vector<LabComponent> labPool;
+        Vector<int32_t> labRecycle;
     };
 
     class DroneData
     {
     public:
         DroneData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 56;
 
         int32_t version;
         Vector3 begin;
@@ -1251,7 +1868,10 @@ public:
     {
     public:
         LocalLogisticOrder();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 28;
 
         int32_t version;
         int32_t otherStationId;
@@ -1266,7 +1886,10 @@ public:
     {
     public:
         ShipData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 164;
 
         int32_t version;
         int32_t stage;
@@ -1295,7 +1918,10 @@ public:
     {
     public:
         RemoteLogisticOrder();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 28;
 
         int32_t version;
         int32_t otherStationGId;
@@ -1310,7 +1936,10 @@ public:
     {
     public:
         StationStore();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 32;
 
         int32_t version;
         int32_t itemId;
@@ -1327,7 +1956,10 @@ public:
     {
     public:
         SlotData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 16;
 
         int32_t dir;
         int32_t beltId;
@@ -1339,7 +1971,14 @@ public:
     {
     public:
         StationComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<2> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t id;
@@ -1362,29 +2001,29 @@ public:
         int32_t idleDroneCount;
         int32_t workDroneCount;
         int32_t workDroneArraySize;
-        std::vector<DroneData> workDroneDatas;
-        std::vector<LocalLogisticOrder> workDroneOrders;
+        Vector<DroneData> workDroneDatas;
+        Vector<LocalLogisticOrder> workDroneOrders;
         int32_t idleShipCount;
         int32_t workShipCount;
         uint64_t idleShipIndices;
         uint64_t workShipIndices;
         int32_t arraySize;
-        std::vector<ShipData> workShipDatas;
-        std::vector<RemoteLogisticOrder> workShipOrders;
+        Vector<ShipData> workShipDatas;
+        Vector<RemoteLogisticOrder> workShipOrders;
         int32_t numStorage;
-        std::vector<StationStore> storage;
+        Vector<StationStore> storage;
         int32_t numSlots;
-        std::vector<SlotData> slots;
+        Vector<SlotData> slots;
         int32_t localPairProcess;
         int32_t remotePairProcess;
         int32_t nextShipIndex;
         bool isCollector;
         int32_t numCollectionIds;
-        std::vector<int32_t> collectionIds;
+        Vector<int32_t> collectionIds;
         int32_t numCollectionPerTick;
-        std::vector<float> collectionPerTick;
+        Vector<float> collectionPerTick;
         int32_t numCurrentCollections;
-        std::vector<float> currentCollections;
+        Vector<float> currentCollections;
         int32_t collectSpeed;
         double tripRangeDrones;
         double tripRangeShips;
@@ -1399,22 +2038,32 @@ public:
     {
     public:
         PlanetTransport();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t stationCursor;
         int32_t stationCapacity;
         int32_t stationRecycleCursor;
-        std::vector<int32_t> stationIndex;
-        std::vector<StationComponent> stationPool;
-        std::vector<int32_t> stationRecycle;
+        Vector<int32_t> stationIndex;
+        Vector<StationComponent> stationPool;
+        Vector<int32_t> stationRecycle;
     };
 
     class MonsterComponent
     {
     public:
         MonsterComponent();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 76;
 
         int32_t version;
         int32_t id;
@@ -1436,34 +2085,268 @@ public:
     {
     public:
         MonsterSystem();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t monsterCapacity;
         int32_t monsterCursor;
         int32_t monsterRecycleCursor;
-        std::vector<MonsterComponent> monsterPool;
-        std::vector<int32_t> monsterRecycle;
+        Vector<MonsterComponent> monsterPool;
+        Vector<int32_t> monsterRecycle;
     };
 
     class PlatformSystem
     {
     public:
         PlatformSystem();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t reformDataByteCount;
-        std::vector<uint8_t> reformData;
+        Vector<uint8_t> reformData;
         int32_t reformOffsetsByteCount;
-        std::vector<uint32_t> reformOffsets;
+        Vector<uint32_t> reformOffsets;
+    };
+
+    enum class EComponentType
+    {
+        Belt, Splitter, Storage, Tank, Miner, Inserter, Assembler, Fractionate, Ejector, Silo, Lab, Station,
+        PowerNode, PowerGenerator, PowerConsumer, PowerAccumulator, PowerExchanger, Monster, Count
+    };
+
+    class PlanetFactory;
+
+    // Lookups between the entities of a PlanetFactory and the components of every pool, by id.  Rows
+    // are positions in entityPool or in the component pool, -1 when the id is not present.
+    class EntityIndex
+    {
+    public:
+        EntityIndex();
+        void build(const PlanetFactory& factory);
+
+        int32_t entityRow(const int32_t entityId) const;
+        int32_t componentRow(const EComponentType type, const int32_t componentId) const;
+        int32_t entityOf(const EComponentType type, const int32_t componentId) const;
+        static int32_t componentOf(const EntityData& entity, const EComponentType type);
+
+    private:
+        template<typename CLASS>
+        void indexPool(const EComponentType type, const Vector<CLASS>& pool);
+
+        static const int32_t typeCount = static_cast<int32_t>(EComponentType::Count);
+
+        Vector<int32_t> m_entityRows;
+        Vector<int32_t> m_componentRows[typeCount];
+        Vector<int32_t> m_componentEntities[typeCount];
+    };
+
+    // The belts of a PlanetFactory as a directed graph in compressed sparse row form, with edges in the
+    // direction cargo moves.  Vertices are the rows of beltPool followed by the rows of splitterPool.  A
+    // splitter is a vertex of its own, so it costs one edge per connected belt rather than one per pair.
+    // build() is linear in the number of belts and splitters and computes components and loops up front.
+    class BeltGraph
+    {
+    public:
+        BeltGraph();
+        void build(const PlanetFactory& factory);
+
+        int32_t vertexCount() const { return static_cast<int32_t>(m_component.size()); }
+        int32_t edgeCount() const { return static_cast<int32_t>(m_targets.size()); }
+        int32_t beltVertex(const int32_t beltId) const;  // -1 when the belt is not present.
+        int32_t splitterVertex(const int32_t splitterId) const;  // -1 when the splitter is not present.
+        bool isSplitter(const int32_t vertex) const { return vertex >= m_beltCount; }
+        int32_t row(const int32_t vertex) const { return isSplitter(vertex) ? vertex - m_beltCount : vertex; }  // In beltPool or splitterPool.
+
+        // Calls function(vertex) for every vertex cargo moves to from vertex, or comes from.
+        template<typename FUNCTION>
+        void forEachOutput(const int32_t vertex, FUNCTION function) const
+        {
+            for (int32_t edge = m_offsets[vertex]; edge < m_offsets[vertex + 1]; ++edge)
+                function(m_targets[edge]);
+        }
+
+        template<typename FUNCTION>
+        void forEachInput(const int32_t vertex, FUNCTION function) const
+        {
+            for (int32_t edge = m_reverseOffsets[vertex]; edge < m_reverseOffsets[vertex + 1]; ++edge)
+                function(m_sources[edge]);
+        }
+
+        // Belts which are linked in either direction share a component.  Free pool slots have none, -1.
+        int32_t component(const int32_t vertex) const { return m_component[vertex]; }
+        int32_t componentCount() const { return m_componentCount; }
+
+        // Loops are the strongly connected sets of more than one vertex, or a vertex feeding itself.
+        int32_t loop(const int32_t vertex) const { return m_loop[vertex]; }  // -1 when vertex is on no loop.
+        int32_t loopCount() const { return m_loopCount; }
+
+        // Every vertex reachable from vertex along the edges, or against them, vertex itself included.
+        Vector<int32_t> downstream(const int32_t vertex) const;
+        Vector<int32_t> upstream(const int32_t vertex) const;
+
+    private:
+        int32_t m_beltCount;
+        Vector<int32_t> m_beltVertices;  // By belt id.
+        Vector<int32_t> m_splitterVertices;  // By splitter id.
+        Vector<int32_t> m_offsets;
+        Vector<int32_t> m_targets;
+        Vector<int32_t> m_reverseOffsets;
+        Vector<int32_t> m_sources;
+        Vector<int32_t> m_component;
+        int32_t m_componentCount;
+        Vector<int32_t> m_loop;
+        int32_t m_loopCount;
+    };
+
+    // The cargo on the belts of a PlanetFactory, decoded from CargoPath::buffer.  A cargo takes 10 buffer
+    // bytes: the marker bytes 246 to 250, its cargoPool index as four base 100 digits, each stored plus
+    // one, and 255.  Empty buffer bytes are 0.  Cargo heads are found 16 bytes at a time with SSE2.
+    class CargoOccupancy
+    {
+    public:
+        CargoOccupancy();
+        void build(const PlanetFactory& factory);
+        void add(const CargoOccupancy& other);  // Sums the totals of another factory, for galaxy-wide totals.
+
+        static const int32_t cargoLength = 10;
+
+        Vector<int32_t> pathCargo;  // By row in pathPool.
+        Vector<float> pathOccupancy;  // By row in pathPool.  The share of the buffer taken by cargo, 0 to 1.
+        Vector<int64_t> itemCounts;  // By item id.
+        int64_t cargoCount;
+        int64_t unknownCargo;  // Cargo whose index is not in cargoPool.
+    };
+
+    // Which cargo paths feed which, for throughput models at path rather than belt granularity.  Vertices
+    // are the rows of pathPool.  A path has an edge to the path it outputs into, and from each of its
+    // inputPaths.  A closed path feeds itself.  Paths are ordered so that feeders come before what they
+    // feed, with the paths of one loop, which have no such order, next to each other.
+    class CargoPathGraph
+    {
+    public:
+        CargoPathGraph();
+        void build(const PlanetFactory& factory);
+
+        int32_t vertexCount() const { return static_cast<int32_t>(m_component.size()); }
+        int32_t edgeCount() const { return static_cast<int32_t>(m_targets.size()); }
+        int32_t pathVertex(const int32_t pathId) const;  // -1 when the path is not present.
+
+        template<typename FUNCTION>
+        void forEachOutput(const int32_t vertex, FUNCTION function) const
+        {
+            for (int32_t edge = m_offsets[vertex]; edge < m_offsets[vertex + 1]; ++edge)
+                function(m_targets[edge]);
+        }
+
+        template<typename FUNCTION>
+        void forEachInput(const int32_t vertex, FUNCTION function) const
+        {
+            for (int32_t edge = m_reverseOffsets[vertex]; edge < m_reverseOffsets[vertex + 1]; ++edge)
+                function(m_sources[edge]);
+        }
+
+        // Every vertex, feeders first.  Propagating flow in this order sees all inputs of a path before
+        // the path itself, except for inputs from the same loop.
+        const Vector<int32_t>& topologicalOrder() const { return m_order; }
+
+        // The strongly connected components, numbered in topological order.  Outside loops every path
+        // is a component of its own.
+        int32_t component(const int32_t vertex) const { return m_component[vertex]; }
+        int32_t componentCount() const { return m_componentCount; }
+
+        int32_t loop(const int32_t vertex) const { return m_loop[vertex]; }  // -1 when vertex is on no loop.
+        int32_t loopCount() const { return m_loopCount; }
+
+        Vector<int32_t> downstream(const int32_t vertex) const;
+        Vector<int32_t> upstream(const int32_t vertex) const;
+
+    private:
+        Vector<int32_t> m_pathVertices;  // By path id.
+        Vector<int32_t> m_offsets;
+        Vector<int32_t> m_targets;
+        Vector<int32_t> m_reverseOffsets;
+        Vector<int32_t> m_sources;
+        Vector<int32_t> m_order;
+        Vector<int32_t> m_component;
+        int32_t m_componentCount;
+        Vector<int32_t> m_loop;
+        int32_t m_loopCount;
+    };
+
+    // Supply against demand for every power network of a PlanetFactory, in flat arrays indexed by network
+    // id.  The totals are summed over the component pools by their networkId, one pass per pool.  The node
+    // graph of each network is rebuilt from connIdsForLoad and checked with union-find.
+    class PowerBalance
+    {
+    public:
+        PowerBalance();
+        void build(const PlanetFactory& factory);
+
+        int32_t networkCount() const { return static_cast<int32_t>(pieces.size()); }  // Highest network id + 1.
+        bool isConnected(const int32_t networkId) const { return pieces[networkId] == 1; }
+        int64_t surplus(const int32_t networkId) const { return generation[networkId] - workDemand[networkId]; }
+
+        Vector<int64_t> generation;  // genEnergyPerTick of the generators.
+        Vector<int64_t> workDemand;  // workEnergyPerTick of the consumers and the charging nodes.
+        Vector<int64_t> idleDemand;  // idleEnergyPerTick of the same.
+        Vector<int64_t> storedEnergy;  // curEnergy of the accumulators.
+        Vector<int64_t> storageCapacity;  // maxEnergy of the accumulators.
+        Vector<int32_t> nodeCount;
+        Vector<int32_t> pieces;  // Parts the node graph falls into.  0 for an id without a network or without nodes.
+    };
+
+    // The power nodes of a PlanetFactory bucketed by powerPoint in a uniform grid, so that a point is only
+    // tested against the nodes near it.  The grid is three dimensional, which keeps the cells the same size
+    // all over the planet, poles included.  Cells are at least as wide as the largest coverRadius, so every
+    // node whose cover reaches a point is in one of the 27 cells around it.  Results are rows in nodePool.
+    // Nodes with a powerPoint or coverRadius which is not finite are left out.
+    class PowerCoverageIndex
+    {
+    public:
+        PowerCoverageIndex();
+        void build(const PlanetFactory& factory);
+
+        int32_t coveringNode(const Vector3& point) const;  // The nearest node whose cover reaches point, or -1.
+        int32_t nearestNode(const Vector3& point) const;  // -1 only when there are no nodes.
+
+        // The same for every record of entityPool in one pass.  Free slots get -1.
+        Vector<int32_t> coveringNodes(const Vector<EntityData>& entities) const;
+        Vector<int32_t> nearestNodes(const Vector<EntityData>& entities) const;
+
+    private:
+        int32_t cellOf(const float value, const int32_t axis) const;
+        float distance2(const int32_t node, const Vector3& point) const;
+
+        float m_origin[3];
+        float m_cellSize;
+        int32_t m_dimensions[3];
+        Vector<int32_t> m_cellStart;  // By cell, into m_nodes.  One more than there are cells.
+        Vector<int32_t> m_nodes;  // Node rows, ordered by cell.
+        Vector<Vector3> m_points;  // By node row.
+        Vector<float> m_coverRadius2;  // By node row.  -1 for a free slot.
     };
 
     class PlanetFactory
     {
     public:
         PlanetFactory();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<1> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t planetId;
@@ -1471,28 +2354,29 @@ public:
         int32_t entityCapacity;
         int32_t entityCursor;
         int32_t entityRecycleCursor;
-        std::vector<EntityData> entityPool;
-        std::vector<AnimData> entityAnimPool;
-        std::vector<SignData> entitySignPool;
-        std::vector<int32_t> entityConnPool;
-        std::vector<int32_t> entityRecycle;
+        Vector<EntityData> entityPool;
+        Vector<AnimData> entityAnimPool;
+        Vector<SignData> entitySignPool;
+        Vector<int32_t> entityConnPool;
+        Vector<int32_t> entityRecycle;
+        EntityTable entityTable;  // Only built with ParseOptions::buildEntityTable.
         int32_t prebuildCapacity;
         int32_t prebuildCursor;
         int32_t prebuildRecycleCursor;
-        std::vector<PrebuildData> prebuildPool;
-        std::vector<int32_t> prebuildConnPool;
-        std::vector<int32_t> prebuildRecycle;
+        Vector<PrebuildData> prebuildPool;
+        Vector<int32_t> prebuildConnPool;
+        Vector<int32_t> prebuildRecycle;
         int32_t vegeCapacity;
         int32_t vegeCursor;
         int32_t vegeRecycleCursor;
-        std::vector<VegeData> vegePool;
-        std::vector<int32_t> vegeRecycle;
+        Vector<VegeData> vegePool;
+        Vector<int32_t> vegeRecycle;
         int32_t veinCapacity;
         int32_t veinCursor;
         int32_t veinRecycleCursor;
-        std::vector<VeinData> veinPool;
-        std::vector<int32_t> veinRecycle;
-        std::vector<AnimData> veinAnimPool;
+        Vector<VeinData> veinPool;
+        Vector<int32_t> veinRecycle;
+        Vector<AnimData> veinAnimPool;
         CargoContainer cargoContainer;
         CargoTraffic cargoTraffic;
         FactoryStorage factoryStorage;
@@ -1501,13 +2385,76 @@ public:
         PlanetTransport transport;
         MonsterSystem monsterSystem;
         PlatformSystem platformSystem;
+        EntityIndex entityIndex;  // Only built with ParseOptions::buildEntityIndex.
+    };
+
+    // Byte offsets of the big sections of a save.  It is stored in a sidecar file next to the save,
+    // keyed by the size and modification time of the save, so that later parses can seek past the
+    // sections they do not need instead of walking them.
+    class SectionIndex
+    {
+    public:
+        SectionIndex();
+        bool load(const std::filesystem::path& savePath);  // False when the sidecar is missing, invalid or stale.
+        bool save(const std::filesystem::path& savePath) const;
+        static std::filesystem::path sidecarPath(const std::filesystem::path& savePath);
+
+        int64_t fileSize;
+        int64_t modifiedTime;
+        int64_t statisticsOffset;
+        int64_t playerOffset;
+        int64_t factoriesOffset;  // factoryCount
+        int64_t dysonSpheresOffset;  // galaxyStarCount
+        int64_t endOffset;
+        std::vector<int32_t> planetIds;
+        std::vector<int64_t> factoryOffsets;
+        std::vector<int64_t> factoryLengths;
+        std::vector<int32_t> dysonSphereIndex;
+        std::vector<int64_t> dysonSphereOffsets;
+    };
+
+    class GameData;
+
+    // Refers to one PlanetFactory by its byte range in the save file.  The factory is parsed on first
+    // access and cached.  Each copy of a handle caches its own factory, copies taken after the first
+    // access start out sharing it.
+    class PlanetFactoryHandle
+    {
+    public:
+        PlanetFactoryHandle();
+        explicit PlanetFactoryHandle(const std::shared_ptr<PlanetFactory>& factory);  // Already loaded, with no source to parse it again from.
+
+        PlanetFactory& get() const;  // An empty factory when loading failed, check failure() first.
+        PlanetFactory& operator*() const { return get(); }
+        PlanetFactory* operator->() const { return &get(); }
+        bool isLoaded() const { return m_factory != nullptr; }
+        void release();  // Drops the cached factory, and its arena with useArena, if it can be parsed again from the file.
+        const ParseFailure& failure() const { return m_failure; }  // Set when loading failed in EErrorMode::Report.
+
+        int32_t planetId;
+        int64_t offset;
+        int64_t length;
+
+    private:
+        friend class GameData;
+        void parse(InputStream& strm);
+        void load(InputStream& source) const;
+        MonotonicArena* createArena(const InputStream& strm) const;
+
+        mutable std::shared_ptr<MonotonicArena> m_arena;  // Declared ahead of m_factory, which it has to outlive.
+        mutable std::shared_ptr<PlanetFactory> m_factory;
+        mutable ParseFailure m_failure;
+        std::shared_ptr<InputStream> m_source;
     };
 
     class DysonSail
     {
     public:
         DysonSail();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 32;
 
         float st;
         Vector3 p;
@@ -1519,7 +2466,10 @@ public:
     {
     public:
         DysonSailInfo();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 24;
 
         uint32_t orbit;
         uint32_t node;
@@ -1531,7 +2481,10 @@ public:
     {
     public:
         SailOrbit();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 45;
 
         int32_t version;
         int32_t id;
@@ -1546,7 +2499,10 @@ public:
     {
     public:
         ExpiryOrder();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 12;
 
         int64_t time;
         int32_t index;
@@ -1556,7 +2512,10 @@ public:
     {
     public:
         AbsorbOrder();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 20;
 
         int64_t time;
         int32_t index;
@@ -1568,7 +2527,10 @@ public:
     {
     public:
         SailBullet();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 116;
 
         int32_t version;
         int32_t id;
@@ -1587,39 +2549,49 @@ public:
     {
     public:
         DysonSwarm();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<4> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t randSeed;
         int32_t sailCapacity;
         int32_t sailCursor;
         int32_t sailRecycleCursor;
-        std::vector<DysonSail> sailPoolForSave;
-        std::vector<DysonSailInfo> sailInfos;
-        std::vector<int32_t> sailRecycle;
+        Vector<DysonSail> sailPoolForSave;
+        Vector<DysonSailInfo> sailInfos;
+        Vector<int32_t> sailRecycle;
         int32_t orbitCapacity;
         int32_t orbitCursor;
-        std::vector<SailOrbit> orbits;
+        Vector<SailOrbit> orbits;
         int32_t numExpiryOrder;
         int32_t expiryCursor;
         int32_t expiryEnding;
-        std::vector<ExpiryOrder> expiryOrder;
+        Vector<ExpiryOrder> expiryOrder;
         int32_t numAbsorbOrder;
         int32_t absorbCursor;
         int32_t absorbEnding;
-        std::vector<AbsorbOrder> absorbOrder;
+        Vector<AbsorbOrder> absorbOrder;
         int32_t bulletCapacity;
         int32_t bulletCursor;
         int32_t bulletRecycleCursor;
-        std::vector<SailBullet> bulletPool;
-        std::vector<int32_t> bulletRecycle;
+        Vector<SailBullet> bulletPool;
+        Vector<int32_t> bulletRecycle;
     };
 
     class DysonNode
     {
     public:
         DysonNode();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 66;
 
         int32_t version;
         int32_t id;
@@ -1643,7 +2615,10 @@ public:
     {
     public:
         DysonFrame();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 38;
 
         int32_t version;
         int32_t id;
@@ -1662,7 +2637,14 @@ public:
     {
     public:
         DysonShell();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t id;
@@ -1670,39 +2652,46 @@ public:
         int32_t layerId;
         int32_t randSeed;
         int32_t numPolygon;
-        std::vector<Vector3> polygon;
+        Vector<Vector3> polygon;
         int32_t numDysonNode;
-        std::vector<int32_t> nodeId;
+        Vector<int32_t> nodeId;
         int32_t vertexCount;
         int32_t triangleCount;
         int32_t numVerts;
-        std::vector<Vector3> verts;
+        Vector<Vector3> verts;
         int32_t numPqArr;
-        std::vector<IntVector2> pqArr;
+        Vector<IntVector2> pqArr;
         int32_t numTris;
-        std::vector<int32_t> tris;
+        Vector<int32_t> tris;
         int32_t numVAdjs;
-        std::vector<int32_t> vAdjs;
+        Vector<int32_t> vAdjs;
         int32_t numVertAttr;
-        std::vector<int32_t> vertAttr;
+        Vector<int32_t> vertAttr;
         int32_t numVertsq;
-        std::vector<int32_t> vertsq;
+        Vector<int32_t> vertsq;
         int32_t numVertsqOffset;
-        std::vector<int32_t> vertsqOffset;
+        Vector<int32_t> vertsqOffset;
         int32_t numNodecps;
-        std::vector<int32_t> nodecps;
+        Vector<int32_t> nodecps;
         int32_t numVertcps;
-        std::vector<int32_t> vertcps;
+        Vector<int32_t> vertcps;
         int32_t vertRecycleArraySize;
         int32_t vertRecycleCursor;
-        std::vector<int32_t> vertRecycle;
+        Vector<int32_t> vertRecycle;
     };
 
     class DysonSphereLayer
     {
     public:
         DysonSphereLayer();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<0> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t id;
@@ -1716,28 +2705,31 @@ public:
         int32_t nodeCapacity;
         int32_t nodeCursor;
         int32_t nodeRecycleCursor;
-        std::vector<int32_t> dysonNodeIndex;
-        std::vector<DysonNode> nodePool;
-        std::vector<int32_t> nodeRecycle;
+        Vector<int32_t> dysonNodeIndex;
+        Vector<DysonNode> nodePool;
+        Vector<int32_t> nodeRecycle;
         int32_t frameCapacity;
         int32_t frameCursor;
         int32_t frameRecycleCursor;
-        std::vector<int32_t> dysonFrameIndex;
-        std::vector<DysonFrame> framePool;
-        std::vector<int32_t> frameRecycle;
+        Vector<int32_t> dysonFrameIndex;
+        Vector<DysonFrame> framePool;
+        Vector<int32_t> frameRecycle;
         int32_t shellCapacity;
         int32_t shellCursor;
         int32_t shellRecycleCursor;
-        std::vector<int32_t> dysonShellIndex;
-        std::vector<DysonShell> shellPool;
-        std::vector<int32_t> shellRecycle;
+        Vector<int32_t> dysonShellIndex;
+        Vector<DysonShell> shellPool;
+        Vector<int32_t> shellRecycle;
     };
 
     class DysonRocket
     {
     public:
         DysonRocket();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 92;
 
         int32_t version;
         int32_t id;
@@ -1756,7 +2748,10 @@ public:
     {
     public:
         DysonNodeRData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        static void skip(InputStream& strm);
+        static const int64_t recordSize = 44;
 
         int32_t version;
         int32_t id;
@@ -1770,7 +2765,14 @@ public:
     {
     public:
         DysonSphere();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<2> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        static void skip(InputStream& strm);
 
         int32_t version;
         int32_t randSeed;
@@ -1778,30 +2780,59 @@ public:
         int32_t twelveTwelve;
         int32_t layerCount;
         int32_t numDysonSphereLayer;
-        std::vector<int32_t> dysonSphereLayerIndex;
-        std::vector<DysonSphereLayer> dysonSphereLayer;
+        Vector<int32_t> dysonSphereLayerIndex;
+        Vector<DysonSphereLayer> dysonSphereLayer;
         int32_t rocketCapacity;
         int32_t rocketCursor;
         int32_t rocketRecycleCursor;
-        std::vector<DysonRocket> rocketPool;
-        std::vector<int32_t> rocketRecycle;
+        Vector<DysonRocket> rocketPool;
+        Vector<int32_t> rocketRecycle;
         int32_t autoNodeCount;
         int32_t numAutoNodes;
-        std::vector<int32_t> autoNodeIncludedFlag;
-        std::vector<int32_t> layerId;
-        std::vector<int32_t> nodeId;
+        Vector<int32_t> autoNodeIncludedFlag;
+        Vector<int32_t> layerId;
+        Vector<int32_t> nodeId;
         int32_t nrdCapacity;
         int32_t nrdCursor;
         int32_t nrdRecycleCursor;
-        std::vector<DysonNodeRData> nrdPool;
-        std::vector<int32_t> nrdRecycle;
+        Vector<DysonNodeRData> nrdPool;
+        Vector<int32_t> nrdRecycle;
+    };
+
+    // Receives records while they are parsed, for exports and aggregations which do not need the object
+    // tree.  The visited pools are not stored: each is parsed through one scratch record, which is only
+    // valid during the callback.  Factories are parsed one after another, even with parallelFactories,
+    // and dropped after onFactoryEnd(), so GameData::factories keeps only planetId and byte range.
+    // Pools indexed by cursor include their free slots, which have an id of 0.
+    class ParseVisitor
+    {
+    public:
+        virtual ~ParseVisitor() {}
+
+        virtual void onFactoryBegin(const int32_t /*planetId*/) {}
+        virtual void onFactoryEnd(const PlanetFactory& /*factory*/) {}  // factory holds the pools which are not visited.
+        virtual void onEntity(const EntityData& /*entity*/) {}
+        virtual void onBelt(const BeltComponent& /*belt*/) {}
+        virtual void onStation(const StationComponent& /*station*/) {}
+        virtual void onDysonSphereBegin(const int32_t /*starIndex*/) {}
+        virtual void onDysonShell(const DysonShell& /*shell*/) {}
+        virtual void onProductStat(const ProductStat& /*stat*/) {}
     };
 
     class GameData
     {
     public:
         GameData();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<2> SupportedVersions;
+        template<int32_t VERSION>
+        void parseVersion(InputStream& strm);
+        template<int32_t VERSION>
+        void serializeVersion(OutputStream& strm) const;
+        void parseFactories(InputStream& strm);
+        void scanFactories(InputStream& strm);
+        void recordFactories();
 
         int32_t version;
         std::string gameName;
@@ -1816,17 +2847,26 @@ public:
         Player mainPlayer;
         int32_t factoryCount;
         GalacticTransport galacticTransport;
-        std::vector<PlanetFactory> factories;
+        std::vector<PlanetFactoryHandle> factories;
         int32_t galaxyStarCount;
-        std::vector<int32_t> dysonSphereIndex;
-        std::vector<DysonSphere> dysonSpheres;
+        Vector<int32_t> dysonSphereIndex;
+        Vector<int32_t> dysonSphereSlot;  // Position of each sphere in the galaxyStarCount loop.
+        Vector<DysonSphere> dysonSpheres;
+        SectionIndex sections;
     };
 
     class GameSave
     {
     public:
         GameSave();
-        void parse(std::ifstream& strm);
+        void parse(InputStream& strm);
+        void serialize(OutputStream& strm) const;
+        typedef Versions<4> SupportedFormats;  // saveFileFormatNumber
+
+        // The snapshot sidecar, see DysonSphereSnapshot.h.  Saving loads any lazy factories first.
+        bool loadSnapshot(const std::filesystem::path& savePath, const ParseOptions& options);  // False when the sidecar is missing, invalid or stale.
+        bool saveSnapshot(const std::filesystem::path& savePath) const;
+        static std::filesystem::path snapshotPath(const std::filesystem::path& savePath);
 
         int64_t fileStreamLength;
         int32_t saveFileFormatNumber;
@@ -1836,27 +2876,119 @@ public:
         int64_t gameTick;
         int64_t nowTicks;
         int32_t sizeOfPngFile;
-        std::vector<uint8_t> screenShotPngFile;
+        Vector<uint8_t> screenShotPngFile;
         GameData data;
     };
 
+    // The fields a save browser lists, read by scanMetadata() without the screenshot or anything after GameDesc.
+    class SaveMetadata
+    {
+    public:
+        SaveMetadata();
+        void parse(InputStream& strm);
+
+        std::filesystem::path path;
+        bool m_readSuccessFlag;
+        std::string m_failureDescription;
+
+        int64_t fileStreamLength;
+        int32_t saveFileFormatNumber;
+        int32_t majorGameVersion;
+        int32_t minorGameVersion;
+        int32_t releaseGameVersion;
+        int64_t gameTick;
+        int64_t nowTicks;
+        int32_t sizeOfPngFile;
+        int32_t gameDataVersion;
+        std::string gameName;
+        GameDesc gameDesc;
+    };
+
+    // The screenshot embedded in a save, found by readThumbnail() without parsing GameData.  When the file
+    // could be mapped, data() points into the mapping, which stays alive as long as the view does.
+    // Otherwise data() is null and offset and size locate the PNG in the file.
+    class ThumbnailView
+    {
+    public:
+        ThumbnailView();
+
+        const uint8_t* data() const { return m_data; }
+        int64_t size() const { return m_size; }
+        int64_t offset() const { return m_offset; }
+
+        bool m_readSuccessFlag;
+        std::string m_failureDescription;
+
+    private:
+        friend class DysonSphereParser;
+
+        const uint8_t* m_data;
+        int64_t m_size;
+        int64_t m_offset;
+        std::shared_ptr<InputStream> m_source;
+    };
+
     template<typename CHAR>
-    DysonSphereParser(const CHAR* const filename);
+    DysonSphereParser(const CHAR* const filename, const EInputMode inputMode = EInputMode::Stream);
+
+    template<typename CHAR>
+    DysonSphereParser(const CHAR* const filename, const ParseOptions& options);
+
+    template<typename CHAR>
+    static SaveMetadata scanMetadata(const CHAR* const filename);
+
+    template<typename CHAR>
+    static ThumbnailView readThumbnail(const CHAR* const filename);
+
+    // Scans every .dsv file directly inside directory in parallel.  The results are sorted by path.
+    static std::vector<SaveMetadata> scanDirectory(const std::filesystem::path& directory, const int32_t threadCount = 0);
+
+    // The saves input names, sorted by path.  input is a save, a directory, whose .dsv files are listed,
+    // or a path whose file name holds * and ? wildcards, such as saves/Autosave*.dsv.
+    static std::vector<std::filesystem::path> findSaves(const std::filesystem::path& input);
+
+    // Called once per save as soon as it is parsed, with m_readSuccessFlag and m_failureDescription set.
+    // Calls come from the worker threads and may overlap.  The parser is destroyed when the call returns.
+    typedef std::function<void(const std::filesystem::path& path, DysonSphereParser& parser)> BatchCallback;
+
+    // Parses paths in parallel.  Workers take the next file from one shared counter over the list sorted
+    // largest first, so that a big save does not start last and run on alone.  Each file is parsed with
+    // options, except that parallelFactories is turned off, since the batch already uses every thread.
+    static void parseBatch(const std::vector<std::filesystem::path>& paths, const ParseOptions& options, const BatchCallback& callback, const int32_t threadCount = 0);
+
+    // Writes gameSave back out as a save file.  Every section has to be present, so the parse must not
+    // have used a projection or a visitor.  Lazy factories are loaded on the way.  An unmodified save is
+    // written back byte for byte.
+    bool save(const std::filesystem::path& path) const;
+
+    // A save with factoryCount factories, for benchmarks on saves larger than any at hand.  The factories
+    // of seed are repeated under new planet ids and fileStreamLength is measured for the result.
+    static GameSave synthesize(const GameSave& seed, const int32_t factoryCount);
+
+    template<typename TYPE>
+    static void byteSwap(TYPE& value)
+    {
+        char* const bytes = reinterpret_cast<char*>(&value);
+        std::reverse(bytes, bytes + sizeof(value));
+    }
 
     template<typename TYPE>
-    static void read(std::ifstream& strm, TYPE& value)
+    static void read(InputStream& strm, TYPE& value)
     {
         strm.read(reinterpret_cast<char*>(&value), sizeof(value));
+#if DSP_BIG_ENDIAN_HOST
+        byteSwap(value);
+#endif
     }
 
-    static void read(std::ifstream& strm, bool& value)
+    static void read(InputStream& strm, bool& value)
     {
         uint8_t raw = 0;
         strm.read(reinterpret_cast<char*>(&raw), 1);
         value = raw ? true : false;
     }
 
-    static void read(std::ifstream& strm, std::string& value)
+    static void read(InputStream& strm, std::string& value)
     {
         uint8_t length = 0;
         read(strm, length);
@@ -1867,17 +2999,46 @@ public:
         delete[] string;
     }
 
+    // Arrays of plain numbers are stored exactly as they are laid out in memory, so they are decoded
+    // with a single block copy.  Everything else, like bool, goes through the per-element read().
+    template<typename TYPE>
+    struct isBlockReadable : std::integral_constant<bool, std::is_arithmetic<TYPE>::value && !std::is_same<TYPE, bool>::value>
+    {
+    };
+
+    // The counted reads take the owning class and field so that a count which cannot fit in the rest
+    // of the file is reported by name.
     template<typename TYPE>
-    static void read(std::ifstream& strm, std::vector<TYPE>& vect, const int32_t size)
+    static void read(InputStream& strm, Vector<TYPE>& vect, const int32_t size, const char* const className = nullptr, const char* const field = nullptr)
     {
+        if (!strm.checkCount(size, sizeof(TYPE), className, field))
+            return;
         vect.resize(size);
+        readBlock(strm, vect, isBlockReadable<TYPE>());
+    }
+
+    template<typename TYPE>
+    static void readBlock(InputStream& strm, Vector<TYPE>& vect, std::true_type)
+    {
+        strm.read(reinterpret_cast<char*>(vect.data()), static_cast<int64_t>(vect.size() * sizeof(TYPE)));
+#if DSP_BIG_ENDIAN_HOST
+        for (auto it = vect.begin(); it != vect.end(); ++it)
+            byteSwap(*it);
+#endif
+    }
+
+    template<typename TYPE>
+    static void readBlock(InputStream& strm, Vector<TYPE>& vect, std::false_type)
+    {
         for (auto it = vect.begin(); it != vect.end(); ++it)
             read(strm, *it);
     }
 
     template<typename TYPE1, typename TYPE2>
-    static void read(std::ifstream& strm, std::vector<TYPE1>& vect1, std::vector<TYPE2>& vect2, const int32_t size)
+    static void read(InputStream& strm, Vector<TYPE1>& vect1, Vector<TYPE2>& vect2, const int32_t size, const char* const className = nullptr, const char* const field = nullptr)
     {
+        if (!strm.checkCount(size, sizeof(TYPE1) + sizeof(TYPE2), className, field))
+            return;
         vect1.resize(size);
         vect2.resize(size);
         auto it1 = vect1.begin();
@@ -1890,8 +3051,10 @@ public:
     }
 
     template<typename TYPE1, typename TYPE2, typename TYPE3>
-    static void read(std::ifstream& strm, std::vector<TYPE1>& vect1, std::vector<TYPE2>& vect2, std::vector<TYPE3>& vect3, const int32_t size)
+    static void read(InputStream& strm, Vector<TYPE1>& vect1, Vector<TYPE2>& vect2, Vector<TYPE3>& vect3, const int32_t size, const char* const className = nullptr, const char* const field = nullptr)
     {
+        if (!strm.checkCount(size, sizeof(TYPE1) + sizeof(TYPE2) + sizeof(TYPE3), className, field))
+            return;
         vect1.resize(size);
         vect2.resize(size);
         vect3.resize(size);
@@ -1907,8 +3070,10 @@ public:
     }
 
     template<typename TYPE1, typename TYPE2>
-    static void read(std::ifstream& strm, std::map<TYPE1, TYPE2>& m, const int32_t size)
+    static void read(InputStream& strm, std::map<TYPE1, TYPE2>& m, const int32_t size, const char* const className = nullptr, const char* const field = nullptr)
     {
+        if (!strm.checkCount(size, 2 * sizeof(int32_t), className, field))
+            return;
         for (int32_t i = 0; i < size; ++i)
         {
             int32_t key = 0;
@@ -1920,8 +3085,10 @@ public:
     }
 
     template<typename TYPE, typename CLASS>
-    static void readi(std::ifstream& strm, std::vector<TYPE>& iVect, std::vector<CLASS>& cVect, const int32_t size)
+    static void readi(InputStream& strm, Vector<TYPE>& iVect, Vector<CLASS>& cVect, const int32_t size, const char* const className = nullptr, const char* const field = nullptr)
     {
+        if (size > 0 && !strm.checkCount(size, sizeof(int32_t), className, field))
+            return;
         for (int i = 0; i < size; ++i)
         {
             int32_t index = 0;
@@ -1941,18 +3108,154 @@ public:
     }
 
     template<typename CLASS>
-    static void readv(std::ifstream& strm, std::vector<CLASS>& instance, const int32_t size)
+    static void readv(InputStream& strm, Vector<CLASS>& instance, const int32_t size, const char* const className = nullptr, const char* const field = nullptr)
     {
-        if (size < 0)
+        if (size < 0 || !strm.checkCount(size, minimumSize<CLASS>(), className, field))
             return;
         instance.resize(size);
         for (auto it = instance.begin(); it != instance.end(); ++it)
             it->parse(strm);
     }
 
+    // Calls instance.parseVersion<version>() and returns false when the version is not in the list.
+    // The list is a template argument, so this compiles down to a chain of compares and direct calls.
+    template<typename CLASS, typename VERSION, int32_t... VERSIONS>
+    static bool dispatchVersion(InputStream& strm, CLASS& instance, const VERSION version, Versions<VERSIONS...>)
+    {
+        return ((version == VERSIONS ? (instance.template parseVersion<VERSIONS>(strm), true) : false) || ...);
+    }
+
+    template<typename VERSION, int32_t... VERSIONS>
+    static constexpr bool supportsVersion(const VERSION version, Versions<VERSIONS...>)
+    {
+        return ((version == VERSIONS) || ...);
+    }
+
+    // Hands the records to the ParseVisitor one at a time instead of storing them in pool.  Without a
+    // visitor these are readv() and readi().
+    template<typename CLASS>
+    static void visitv(InputStream& strm, Vector<CLASS>& pool, const int32_t size, void (ParseVisitor::*callback)(const CLASS&), const char* const className, const char* const field)
+    {
+        ParseVisitor* const visitor = strm.options().visitor;
+        if (visitor == nullptr)
+        {
+            readv(strm, pool, size, className, field);
+            return;
+        }
+        if (size < 0 || !strm.checkCount(size, minimumSize<CLASS>(), className, field))
+            return;
+        CLASS scratch;
+        for (int32_t i = 0; i < size; ++i)
+        {
+            scratch.parse(strm);
+            (visitor->*callback)(scratch);
+        }
+    }
+
+    template<typename TYPE, typename CLASS>
+    static void visiti(InputStream& strm, Vector<TYPE>& iVect, Vector<CLASS>& cVect, const int32_t size, void (ParseVisitor::*callback)(const CLASS&), const char* const className, const char* const field)
+    {
+        ParseVisitor* const visitor = strm.options().visitor;
+        if (visitor == nullptr)
+        {
+            readi(strm, iVect, cVect, size, className, field);
+            return;
+        }
+        if (size > 0 && !strm.checkCount(size, sizeof(int32_t), className, field))
+            return;
+        CLASS scratch;
+        for (int32_t i = 0; i < size; ++i)
+        {
+            int32_t index = 0;
+            read(strm, index);
+            if (index != 0)
+            {
+                scratch.parse(strm);
+                (visitor->*callback)(scratch);
+            }
+        }
+    }
+
+    template<typename TYPE>
+    static void skipArray(InputStream& strm, const int32_t size)
+    {
+        if (size > 0)
+            strm.skip(static_cast<int64_t>(size) * sizeof(TYPE));
+    }
+
+    // Classes with a recordSize have the same number of bytes on disk for every record, so a whole
+    // pool of them is skipped with one jump.  Variable size records are walked one by one.
+    template<typename CLASS, typename = void>
+    struct isFixedSize : std::false_type
+    {
+    };
+
+    template<typename CLASS>
+    struct isFixedSize<CLASS, decltype(void(CLASS::recordSize))> : std::true_type
+    {
+    };
+
+    // Fewest bytes a record of CLASS can take on disk, for checking counts before allocating.
+    template<typename CLASS>
+    static constexpr int64_t minimumSize()
+    {
+        if constexpr (isFixedSize<CLASS>::value)
+            return CLASS::recordSize;
+        else
+            return 1;
+    }
+
+    // The skips check their counts like readv() and readi(), so a corrupt count fails the stream instead
+    // of walking billions of records of zeros.
+    template<typename CLASS>
+    static void skipv(InputStream& strm, const int32_t size, const char* const className, const char* const field)
+    {
+        if (size < 0 || !strm.checkCount(size, minimumSize<CLASS>(), className, field))
+            return;
+        skipBlock<CLASS>(strm, size, isFixedSize<CLASS>());
+    }
+
+    template<typename CLASS>
+    static void skipBlock(InputStream& strm, const int32_t size, std::true_type)
+    {
+        strm.skip(size * CLASS::recordSize);
+    }
+
+    template<typename CLASS>
+    static void skipBlock(InputStream& strm, const int32_t size, std::false_type)
+    {
+        for (int32_t i = 0; i < size && strm; ++i)
+            CLASS::skip(strm);
+    }
+
+    template<typename CLASS>
+    static void parseOrSkip(InputStream& strm, CLASS& instance, const bool selected)
+    {
+        if (selected)
+            instance.parse(strm);
+        else
+            CLASS::skip(strm);
+    }
+
+    template<typename CLASS>
+    static void skipi(InputStream& strm, const int32_t size, const char* const className, const char* const field)
+    {
+        if (size > 0 && !strm.checkCount(size, sizeof(int32_t), className, field))
+            return;
+        for (int32_t i = 0; i < size && strm; ++i)
+        {
+            int32_t index = 0;
+            read(strm, index);
+            if (index != 0)
+                CLASS::skip(strm);
+        }
+    }
+
     template<typename CLASS1, typename CLASS2>
-    static void readv(std::ifstream& strm, std::vector<CLASS1>& instance1, std::vector<CLASS2>& instance2, const int32_t size)
+    static void readv(InputStream& strm, Vector<CLASS1>& instance1, Vector<CLASS2>& instance2, const int32_t size, const char* const className = nullptr, const char* const field = nullptr)
     {
+        if (!strm.checkCount(size, minimumSize<CLASS1>() + minimumSize<CLASS2>(), className, field))
+            return;
         instance1.resize(size);
         instance2.resize(size);
         for (int32_t i = 0; i < size; ++i)
@@ -1963,14 +3266,172 @@ public:
     }
 
     template<typename ENUM, typename TYPE>
-    static void read(std::ifstream& strm, ENUM& e)
+    static void read(InputStream& strm, ENUM& e)
     {
         TYPE temp = 0;
-        strm.read(reinterpret_cast<char*>(&temp), sizeof(temp));
+        read(strm, temp);
         e = static_cast<ENUM>(temp);
     }
 
+    // The writer mirrors the readers above, one write() per read(), so serialize() lays every record
+    // out the way parse() expects it.  Counts are not derived: the count members are written as they
+    // are, so a changed container needs its count member updated to match.
+    template<typename TYPE>
+    static void write(OutputStream& strm, const TYPE& value)
+    {
+#if DSP_BIG_ENDIAN_HOST
+        TYPE swapped = value;
+        byteSwap(swapped);
+        strm.write(reinterpret_cast<const char*>(&swapped), sizeof(swapped));
+#else
+        strm.write(reinterpret_cast<const char*>(&value), sizeof(value));
+#endif
+    }
+
+    static void write(OutputStream& strm, const bool value)
+    {
+        const uint8_t raw = value ? 1 : 0;
+        strm.write(reinterpret_cast<const char*>(&raw), 1);
+    }
+
+    // The length prefix is one byte, as in read(), so longer strings are cut at 255 bytes.
+    static void write(OutputStream& strm, const std::string& value)
+    {
+        const uint8_t length = static_cast<uint8_t>(std::min<size_t>(value.size(), 255));
+        write(strm, length);
+        strm.write(value.data(), length);
+    }
+
+    template<typename TYPE>
+    static void write(OutputStream& strm, const Vector<TYPE>& vect)
+    {
+        writeBlock(strm, vect, isBlockReadable<TYPE>());
+    }
+
+    template<typename TYPE>
+    static void writeBlock(OutputStream& strm, const Vector<TYPE>& vect, std::true_type)
+    {
+#if DSP_BIG_ENDIAN_HOST
+        for (auto it = vect.begin(); it != vect.end(); ++it)
+            write(strm, *it);
+#else
+        strm.write(reinterpret_cast<const char*>(vect.data()), static_cast<int64_t>(vect.size() * sizeof(TYPE)));
+#endif
+    }
+
+    template<typename TYPE>
+    static void writeBlock(OutputStream& strm, const Vector<TYPE>& vect, std::false_type)
+    {
+        for (auto it = vect.begin(); it != vect.end(); ++it)
+            write(strm, *it);
+    }
+
+    template<typename TYPE1, typename TYPE2>
+    static void write(OutputStream& strm, const Vector<TYPE1>& vect1, const Vector<TYPE2>& vect2)
+    {
+        for (size_t i = 0; i < vect1.size() && i < vect2.size(); ++i)
+        {
+            write(strm, vect1[i]);
+            write(strm, vect2[i]);
+        }
+    }
+
+    template<typename TYPE1, typename TYPE2, typename TYPE3>
+    static void write(OutputStream& strm, const Vector<TYPE1>& vect1, const Vector<TYPE2>& vect2, const Vector<TYPE3>& vect3)
+    {
+        for (size_t i = 0; i < vect1.size() && i < vect2.size() && i < vect3.size(); ++i)
+        {
+            write(strm, vect1[i]);
+            write(strm, vect2[i]);
+            write(strm, vect3[i]);
+        }
+    }
+
+    // Written in key order, so a save round-trips byte for byte only if its keys were unique and sorted.
+    template<typename TYPE1, typename TYPE2>
+    static void write(OutputStream& strm, const std::map<TYPE1, TYPE2>& m)
+    {
+        for (auto it = m.begin(); it != m.end(); ++it)
+        {
+            write(strm, static_cast<int32_t>(it->first));
+            write(strm, static_cast<int32_t>(it->second));
+        }
+    }
+
+    // readi() keeps only the occupied slots, so the writer has to put the empty ones back.  The game
+    // stores each record's 1-based slot as its index, so a record goes into the slot its index names.
+    // Records whose index is not a slot, such as plain 1 flags, go into the first free slot, and none
+    // is ever pushed so far that the records after it no longer fit.
+    static bool isSlotOf(const int32_t index, const int32_t slot, const int32_t size, const size_t remaining)
+    {
+        return index <= slot + 1 || static_cast<size_t>(size - slot) <= remaining;
+    }
+
+    template<typename TYPE, typename CLASS>
+    static void writei(OutputStream& strm, const Vector<TYPE>& iVect, const Vector<CLASS>& cVect, const int32_t size)
+    {
+        size_t next = 0;
+        for (int32_t i = 0; i < size; ++i)
+        {
+            if (next < cVect.size() && next < iVect.size() && isSlotOf(iVect[next], i, size, cVect.size() - next))
+            {
+                write(strm, static_cast<int32_t>(iVect[next]));
+                cVect[next].serialize(strm);
+                ++next;
+            }
+            else
+            {
+                write(strm, int32_t(0));
+            }
+        }
+    }
+
+    template<typename CLASS>
+    static void writev(OutputStream& strm, const Vector<CLASS>& instance)
+    {
+        for (auto it = instance.begin(); it != instance.end(); ++it)
+            it->serialize(strm);
+    }
+
+    template<typename CLASS1, typename CLASS2>
+    static void writev(OutputStream& strm, const Vector<CLASS1>& instance1, const Vector<CLASS2>& instance2)
+    {
+        for (size_t i = 0; i < instance1.size() && i < instance2.size(); ++i)
+        {
+            instance1[i].serialize(strm);
+            instance2[i].serialize(strm);
+        }
+    }
+
+    template<typename ENUM, typename TYPE>
+    static void write(OutputStream& strm, const ENUM e)
+    {
+        write(strm, static_cast<TYPE>(e));
+    }
+
+    // The writing side of dispatchVersion().  A record of a version this binary cannot decode could
+    // not have been parsed either, so it fails the stream.
+    template<typename CLASS, typename VERSION, int32_t... VERSIONS>
+    static void dispatchSerialize(OutputStream& strm, const CLASS& instance, const VERSION version, Versions<VERSIONS...>)
+    {
+        if (!((version == VERSIONS ? (instance.template serializeVersion<VERSIONS>(strm), true) : false) || ...))
+            strm.fail();
+    }
+
+private:
+    // Declared ahead of gameSave so that it outlives the pools allocated from it.
+    std::shared_ptr<MonotonicArena> m_arena;
+
+public:
     GameSave gameSave;
     bool m_readSuccessFlag;
     std::string m_failureDescription;
+    ParseFailure m_failure;
+
+private:
+    template<typename CHAR>
+    void load(const CHAR* const filename, const ParseOptions& options);
+
+    template<typename HEADER>
+    static void parseHeader(InputStream& strm, HEADER& header);
 };
@@ -0,0 +1,1897 @@
+//
+// Copyright (c) 2021, Aaron Shumate
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE.txt file in the root directory of this source tree.
+//
+// Dyson Sphere Program is developed by Youthcat Studio and published by Gamera Game.
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <tuple>
+#include "DysonSphereParser.h"
+
+// Field tables for the flat save classes, the ones whose records are a plain sequence of scalars,
+// enums, nested flat classes and counted arrays.  One table drives parse(), skip(), serialize(), the
+// on-disk and in-memory sizes and the CSV export, so those can no longer drift apart from each other.
+// Classes with conditional or interleaved layouts keep their hand-written parse() and serialize().
+template<typename CLASS>
+struct DysonSphereSchema;
+
+template<typename CLASS>
+void schemaParse(DysonSphereParser::InputStream& strm, CLASS& instance);
+template<typename CLASS>
+void schemaWrite(DysonSphereParser::OutputStream& strm, const CLASS& instance);
+template<typename CLASS>
+void schemaSkip(DysonSphereParser::InputStream& strm);
+template<typename CLASS>
+constexpr int64_t schemaFixedSize();
+template<typename CLASS>
+int64_t schemaByteSize(const CLASS& instance);
+template<typename CLASS>
+int64_t schemaHeapBytes(const CLASS& instance);
+template<typename CLASS, typename VISITOR>
+void schemaVisit(const CLASS& instance, VISITOR& visitor, const std::string& prefix = std::string());
+
+// Bytes a scalar takes on disk, or -1 when it has a length prefix.
+template<typename TYPE>
+constexpr int64_t schemaScalarSize()
+{
+    return std::is_same<TYPE, std::string>::value ? -1 : static_cast<int64_t>(sizeof(TYPE));
+}
+
+// Sum of the sizes, or -1 when any of them is variable.
+template<typename... SIZES>
+constexpr int64_t schemaSum(const SIZES... sizes)
+{
+    int64_t total = 0;
+    bool variable = false;
+    for (const int64_t size : { int64_t(0), static_cast<int64_t>(sizes)... })
+    {
+        if (size < 0)
+            variable = true;
+        total += size;
+    }
+    return variable ? -1 : total;
+}
+
+template<typename CLASS, typename TYPE>
+struct SchemaField
+{
+    const char* name;
+    TYPE CLASS::* member;
+
+    void parse(DysonSphereParser::InputStream& strm, CLASS& instance) const
+    {
+        DysonSphereParser::read(strm, instance.*member);
+    }
+
+    void write(DysonSphereParser::OutputStream& strm, const CLASS& instance) const
+    {
+        DysonSphereParser::write(strm, instance.*member);
+    }
+
+    // Scalars are read rather than jumped over because later arrays may take their count from them.
+    void skip(DysonSphereParser::InputStream& strm, CLASS& scratch) const
+    {
+        DysonSphereParser::read(strm, scratch.*member);
+    }
+
+    static constexpr int64_t fixedSize()
+    {
+        return schemaScalarSize<TYPE>();
+    }
+
+    int64_t byteSize(const CLASS& instance) const
+    {
+        if constexpr (std::is_same<TYPE, std::string>::value)
+            return 1 + static_cast<int64_t>((instance.*member).size());
+        else
+            return sizeof(TYPE);
+    }
+
+    int64_t heapBytes(const CLASS& instance) const
+    {
+        if constexpr (std::is_same<TYPE, std::string>::value)
+            return (instance.*member).capacity() > std::string().capacity() ? static_cast<int64_t>((instance.*member).capacity()) + 1 : 0;
+        else
+            return 0;
+    }
+
+    template<typename VISITOR>
+    void visit(const CLASS& instance, VISITOR& visitor, const std::string& prefix) const
+    {
+        visitor(prefix + name, instance.*member);
+    }
+};
+
+template<typename CLASS, typename TYPE, typename STORAGE>
+struct SchemaEnum
+{
+    const char* name;
+    TYPE CLASS::* member;
+
+    void parse(DysonSphereParser::InputStream& strm, CLASS& instance) const
+    {
+        DysonSphereParser::read<TYPE, STORAGE>(strm, instance.*member);
+    }
+
+    void write(DysonSphereParser::OutputStream& strm, const CLASS& instance) const
+    {
+        DysonSphereParser::write<TYPE, STORAGE>(strm, instance.*member);
+    }
+
+    void skip(DysonSphereParser::InputStream& strm, CLASS&) const
+    {
+        strm.skip(sizeof(STORAGE));
+    }
+
+    static constexpr int64_t fixedSize()
+    {
+        return sizeof(STORAGE);
+    }
+
+    int64_t byteSize(const CLASS&) const
+    {
+        return sizeof(STORAGE);
+    }
+
+    int64_t heapBytes(const CLASS&) const
+    {
+        return 0;
+    }
+
+    template<typename VISITOR>
+    void visit(const CLASS& instance, VISITOR& visitor, const std::string& prefix) const
+    {
+        visitor(prefix + name, static_cast<STORAGE>(instance.*member));
+    }
+};
+
+template<typename CLASS, typename TYPE>
+struct SchemaNested
+{
+    const char* name;
+    TYPE CLASS::* member;
+
+    void parse(DysonSphereParser::InputStream& strm, CLASS& instance) const
+    {
+        (instance.*member).parse(strm);
+    }
+
+    void write(DysonSphereParser::OutputStream& strm, const CLASS& instance) const
+    {
+        (instance.*member).serialize(strm);
+    }
+
+    void skip(DysonSphereParser::InputStream& strm, CLASS&) const
+    {
+        schemaSkip<TYPE>(strm);
+    }
+
+    static constexpr int64_t fixedSize()
+    {
+        return schemaFixedSize<TYPE>();
+    }
+
+    int64_t byteSize(const CLASS& instance) const
+    {
+        return schemaByteSize(instance.*member);
+    }
+
+    int64_t heapBytes(const CLASS& instance) const
+    {
+        return schemaHeapBytes(instance.*member);
+    }
+
+    template<typename VISITOR>
+    void visit(const CLASS& instance, VISITOR& visitor, const std::string& prefix) const
+    {
+        schemaVisit(instance.*member, visitor, prefix + name + ".");
+    }
+};
+
+template<typename CLASS, typename TYPE, typename COUNT>
+struct SchemaArray
+{
+    const char* name;
+    DysonSphereParser::Vector<TYPE> CLASS::* member;
+    COUNT CLASS::* count;
+
+    void parse(DysonSphereParser::InputStream& strm, CLASS& instance) const
+    {
+        DysonSphereParser::read(strm, instance.*member, instance.*count, DysonSphereSchema<CLASS>::className, name);
+    }
+
+    void write(DysonSphereParser::OutputStream& strm, const CLASS& instance) const
+    {
+        DysonSphereParser::write(strm, instance.*member);
+    }
+
+    void skip(DysonSphereParser::InputStream& strm, CLASS& scratch) const
+    {
+        DysonSphereParser::skipArray<TYPE>(strm, scratch.*count);
+    }
+
+    static constexpr int64_t fixedSize()
+    {
+        return -1;
+    }
+
+    int64_t byteSize(const CLASS& instance) const
+    {
+        return static_cast<int64_t>((instance.*member).size() * sizeof(TYPE));
+    }
+
+    int64_t heapBytes(const CLASS& instance) const
+    {
+        return static_cast<int64_t>((instance.*member).capacity() * sizeof(TYPE));
+    }
+
+    template<typename VISITOR>
+    void visit(const CLASS& instance, VISITOR& visitor, const std::string& prefix) const
+    {
+        visitor(prefix + name, instance.*member);
+    }
+};
+
+// Maps are stored as count pairs of int32 key and value.
+template<typename CLASS, typename KEY, typename VALUE, typename COUNT>
+struct SchemaMap
+{
+    const char* name;
+    std::map<KEY, VALUE> CLASS::* member;
+    COUNT CLASS::* count;
+
+    void parse(DysonSphereParser::InputStream& strm, CLASS& instance) const
+    {
+        DysonSphereParser::read(strm, instance.*member, instance.*count, DysonSphereSchema<CLASS>::className, name);
+    }
+
+    void write(DysonSphereParser::OutputStream& strm, const CLASS& instance) const
+    {
+        DysonSphereParser::write(strm, instance.*member);
+    }
+
+    void skip(DysonSphereParser::InputStream& strm, CLASS& scratch) const
+    {
+        DysonSphereParser::skipArray<int64_t>(strm, scratch.*count);
+    }
+
+    static constexpr int64_t fixedSize()
+    {
+        return -1;
+    }
+
+    int64_t byteSize(const CLASS& instance) const
+    {
+        return static_cast<int64_t>(instance.*count) * 2 * sizeof(int32_t);
+    }
+
+    // Approximates a tree node as the pair plus three links and the colour.
+    int64_t heapBytes(const CLASS& instance) const
+    {
+        return static_cast<int64_t>((instance.*member).size() * (sizeof(std::pair<const KEY, VALUE>) + 4 * sizeof(void*)));
+    }
+
+    template<typename VISITOR>
+    void visit(const CLASS& instance, VISITOR& visitor, const std::string& prefix) const
+    {
+        visitor(prefix + name, instance.*member);
+    }
+};
+
+template<typename CLASS, typename TYPE>
+constexpr SchemaField<CLASS, TYPE> schemaField(const char* name, TYPE CLASS::* member)
+{
+    return { name, member };
+}
+
+// The field which selects the table of a versioned class.  It comes first in every one of its tables.
+template<typename CLASS, typename TYPE>
+constexpr SchemaField<CLASS, TYPE> schemaVersion(const char* name, TYPE CLASS::* member)
+{
+    return { name, member };
+}
+
+template<typename STORAGE, typename CLASS, typename TYPE>
+constexpr SchemaEnum<CLASS, TYPE, STORAGE> schemaEnum(const char* name, TYPE CLASS::* member)
+{
+    return { name, member };
+}
+
+template<typename CLASS, typename TYPE>
+constexpr SchemaNested<CLASS, TYPE> schemaNested(const char* name, TYPE CLASS::* member)
+{
+    return { name, member };
+}
+
+template<typename CLASS, typename TYPE, typename COUNT>
+constexpr SchemaArray<CLASS, TYPE, COUNT> schemaArray(const char* name, DysonSphereParser::Vector<TYPE> CLASS::* member, COUNT CLASS::* count)
+{
+    return { name, member, count };
+}
+
+template<typename CLASS, typename KEY, typename VALUE, typename COUNT>
+constexpr SchemaMap<CLASS, KEY, VALUE, COUNT> schemaMap(const char* name, std::map<KEY, VALUE> CLASS::* member, COUNT CLASS::* count)
+{
+    return { name, member, count };
+}
+
+// A versioned class lists the versions it can decode in SupportedVersions and has one table for each,
+// fields(Versions<VERSION>()).  The version read from the file selects the table the way dispatchVersion()
+// selects parseVersion(), so supporting a new game patch means adding its version and its table.
+template<typename CLASS, typename = void>
+struct SchemaIsVersioned : std::false_type
+{
+};
+
+template<typename CLASS>
+struct SchemaIsVersioned<CLASS, std::void_t<typename DysonSphereSchema<CLASS>::SupportedVersions>> : std::true_type
+{
+};
+
+template<int32_t... VERSIONS>
+constexpr int32_t schemaLatestVersion(DysonSphereParser::Versions<VERSIONS...>)
+{
+    return std::max({ VERSIONS... });
+}
+
+// The table of the newest version, or the only table of a class without versions.
+template<typename CLASS>
+constexpr auto schemaFields()
+{
+    if constexpr (SchemaIsVersioned<CLASS>::value)
+        return DysonSphereSchema<CLASS>::fields(DysonSphereParser::Versions<schemaLatestVersion(typename DysonSphereSchema<CLASS>::SupportedVersions())>());
+    else
+        return DysonSphereSchema<CLASS>::fields();
+}
+
+template<typename CLASS>
+constexpr auto schemaVersionMember()
+{
+    return std::get<0>(schemaFields<CLASS>()).member;
+}
+
+// Calls function with the table of version and returns false when the version is not in the list.
+template<typename CLASS, typename VERSION, typename FUNCTION, int32_t... VERSIONS>
+bool schemaDispatch(const VERSION version, const FUNCTION& function, DysonSphereParser::Versions<VERSIONS...>)
+{
+    return ((version == VERSIONS ? (function(DysonSphereSchema<CLASS>::fields(DysonSphereParser::Versions<VERSIONS>())), true) : false) || ...);
+}
+
+// Calls function with the table instance was read with.  A version which is not supported, like that of
+// a default constructed record, gets the newest table.
+template<typename CLASS, typename FUNCTION>
+void schemaWithFields(const CLASS& instance, const FUNCTION& function)
+{
+    if constexpr (SchemaIsVersioned<CLASS>::value)
+    {
+        if (schemaDispatch<CLASS>(instance.*schemaVersionMember<CLASS>(), function, typename DysonSphereSchema<CLASS>::SupportedVersions()))
+            return;
+    }
+    function(schemaFields<CLASS>());
+}
+
+template<typename CLASS>
+void schemaParse(DysonSphereParser::InputStream& strm, CLASS& instance)
+{
+    if constexpr (SchemaIsVersioned<CLASS>::value)
+    {
+        DysonSphereParser::read(strm, instance.*schemaVersionMember<CLASS>());
+        const bool supported = schemaDispatch<CLASS>(instance.*schemaVersionMember<CLASS>(), [&](const auto& table)
+        {
+            std::apply([&](const auto&, const auto&... fields) { (fields.parse(strm, instance), ...); }, table);
+        }, typename DysonSphereSchema<CLASS>::SupportedVersions());
+        if (!supported)
+            strm.fail(DysonSphereSchema<CLASS>::className, std::get<0>(schemaFields<CLASS>()).name);
+    }
+    else
+    {
+        std::apply([&](const auto&... fields) { (fields.parse(strm, instance), ...); }, schemaFields<CLASS>());
+    }
+}
+
+template<typename CLASS>
+void schemaWrite(DysonSphereParser::OutputStream& strm, const CLASS& instance)
+{
+    auto write = [&](const auto& table)
+    {
+        std::apply([&](const auto&... fields) { (fields.write(strm, instance), ...); }, table);
+    };
+    if constexpr (SchemaIsVersioned<CLASS>::value)
+    {
+        if (!schemaDispatch<CLASS>(instance.*schemaVersionMember<CLASS>(), write, typename DysonSphereSchema<CLASS>::SupportedVersions()))
+            strm.fail();
+    }
+    else
+    {
+        write(schemaFields<CLASS>());
+    }
+}
+
+template<typename TABLE>
+constexpr int64_t schemaTableFixedSize(const TABLE& table)
+{
+    return std::apply([](const auto&... fields) { return schemaSum(fields.fixedSize()...); }, table);
+}
+
+template<typename CLASS, int32_t... VERSIONS>
+constexpr int64_t schemaVersionsFixedSize(DysonSphereParser::Versions<VERSIONS...>)
+{
+    const int64_t sizes[] = { schemaTableFixedSize(DysonSphereSchema<CLASS>::fields(DysonSphereParser::Versions<VERSIONS>()))... };
+    for (const int64_t size : sizes)
+    {
+        if (size != sizes[0])
+            return -1;
+    }
+    return sizes[0];
+}
+
+// Bytes every record of CLASS takes on disk, or -1 when the class contains arrays or strings, or when
+// its versions differ in size.
+template<typename CLASS>
+constexpr int64_t schemaFixedSize()
+{
+    if constexpr (SchemaIsVersioned<CLASS>::value)
+        return schemaVersionsFixedSize<CLASS>(typename DysonSphereSchema<CLASS>::SupportedVersions());
+    else
+        return schemaTableFixedSize(schemaFields<CLASS>());
+}
+
+// Fixed size records are one jump.  Otherwise the scalars are read into a scratch record so that
+// arrays can be jumped over by their counts.
+template<typename CLASS>
+void schemaSkip(DysonSphereParser::InputStream& strm)
+{
+    if constexpr (schemaFixedSize<CLASS>() >= 0)
+    {
+        strm.skip(schemaFixedSize<CLASS>());
+    }
+    else if constexpr (SchemaIsVersioned<CLASS>::value)
+    {
+        CLASS scratch;
+        DysonSphereParser::read(strm, scratch.*schemaVersionMember<CLASS>());
+        const bool supported = schemaDispatch<CLASS>(scratch.*schemaVersionMember<CLASS>(), [&](const auto& table)
+        {
+            std::apply([&](const auto&, const auto&... fields) { (fields.skip(strm, scratch), ...); }, table);
+        }, typename DysonSphereSchema<CLASS>::SupportedVersions());
+        if (!supported)
+            strm.fail(DysonSphereSchema<CLASS>::className, std::get<0>(schemaFields<CLASS>()).name);
+    }
+    else
+    {
+        CLASS scratch;
+        std::apply([&](const auto&... fields) { (fields.skip(strm, scratch), ...); }, schemaFields<CLASS>());
+    }
+}
+
+// Bytes instance took on disk.
+template<typename CLASS>
+int64_t schemaByteSize(const CLASS& instance)
+{
+    if constexpr (schemaFixedSize<CLASS>() >= 0)
+    {
+        return schemaFixedSize<CLASS>();
+    }
+    else
+    {
+        int64_t bytes = 0;
+        schemaWithFields(instance, [&](const auto& table)
+        {
+            bytes = std::apply([&](const auto&... fields) { return (int64_t(0) + ... + fields.byteSize(instance)); }, table);
+        });
+        return bytes;
+    }
+}
+
+// Heap bytes owned by instance, not counting sizeof(CLASS) itself.
+template<typename CLASS>
+int64_t schemaHeapBytes(const CLASS& instance)
+{
+    if constexpr (schemaFixedSize<CLASS>() >= 0)
+    {
+        return 0;
+    }
+    else
+    {
+        int64_t bytes = 0;
+        schemaWithFields(instance, [&](const auto& table)
+        {
+            bytes = std::apply([&](const auto&... fields) { return (int64_t(0) + ... + fields.heapBytes(instance)); }, table);
+        });
+        return bytes;
+    }
+}
+
+// Bytes a parsed pool occupies in memory.
+template<typename CLASS>
+int64_t schemaFootprint(const DysonSphereParser::Vector<CLASS>& pool)
+{
+    int64_t bytes = static_cast<int64_t>(pool.capacity() * sizeof(CLASS));
+    if constexpr (schemaFixedSize<CLASS>() < 0)
+    {
+        for (const auto& instance : pool)
+            bytes += schemaHeapBytes(instance);
+    }
+    return bytes;
+}
+
+// Calls visitor(name, value) for every field in file order.  Nested classes are flattened with
+// dotted names, enums are passed as their storage type and arrays and maps are passed whole.
+template<typename CLASS, typename VISITOR>
+void schemaVisit(const CLASS& instance, VISITOR& visitor, const std::string& prefix)
+{
+    schemaWithFields(instance, [&](const auto& table)
+    {
+        std::apply([&](const auto&... fields) { (fields.visit(instance, visitor, prefix), ...); }, table);
+    });
+}
+
+template<typename TYPE>
+void schemaWriteCsvValue(std::ostream& os, const TYPE& value)
+{
+    if constexpr (std::is_floating_point<TYPE>::value)
+    {
+        const std::streamsize precision = os.precision(std::numeric_limits<TYPE>::max_digits10);
+        os << value;
+        os.precision(precision);
+    }
+    else
+    {
+        os << +value;
+    }
+}
+
+inline void schemaWriteCsvValue(std::ostream& os, const std::string& value)
+{
+    os << '"';
+    for (const char c : value)
+    {
+        if (c == '"')
+            os << '"';
+        os << c;
+    }
+    os << '"';
+}
+
+// Arrays and maps go in one cell, with elements separated by ';' and keys by ':'.
+template<typename TYPE>
+void schemaWriteCsvValue(std::ostream& os, const DysonSphereParser::Vector<TYPE>& values)
+{
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (i != 0)
+            os << ';';
+        schemaWriteCsvValue(os, values[i]);
+    }
+}
+
+template<typename KEY, typename VALUE>
+void schemaWriteCsvValue(std::ostream& os, const std::map<KEY, VALUE>& values)
+{
+    bool first = true;
+    for (const auto& entry : values)
+    {
+        if (!first)
+            os << ';';
+        schemaWriteCsvValue(os, entry.first);
+        os << ':';
+        schemaWriteCsvValue(os, entry.second);
+        first = false;
+    }
+}
+
+template<typename CLASS>
+void schemaWriteCsvHeader(std::ostream& os)
+{
+    const CLASS sample;
+    bool first = true;
+    auto visitor = [&](const std::string& name, const auto&)
+    {
+        if (!first)
+            os << ',';
+        os << name;
+        first = false;
+    };
+    schemaVisit(sample, visitor);
+    os << '\n';
+}
+
+template<typename CLASS>
+void schemaWriteCsvRow(std::ostream& os, const CLASS& instance)
+{
+    bool first = true;
+    auto visitor = [&](const std::string&, const auto& value)
+    {
+        if (!first)
+            os << ',';
+        schemaWriteCsvValue(os, value);
+        first = false;
+    };
+    schemaVisit(instance, visitor);
+    os << '\n';
+}
+
+template<typename CLASS>
+void schemaWriteCsv(std::ostream& os, const DysonSphereParser::Vector<CLASS>& pool)
+{
+    schemaWriteCsvHeader<CLASS>(os);
+    for (const auto& instance : pool)
+        schemaWriteCsvRow(os, instance);
+}
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::IntVector2>
+{
+    typedef DysonSphereParser::IntVector2 Class;
+    static constexpr const char* className = "IntVector2";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("x", &Class::x),
+            schemaField("y", &Class::y));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::Vector3>
+{
+    typedef DysonSphereParser::Vector3 Class;
+    static constexpr const char* className = "Vector3";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("x", &Class::x),
+            schemaField("y", &Class::y),
+            schemaField("z", &Class::z));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::VectorLF3>
+{
+    typedef DysonSphereParser::VectorLF3 Class;
+    static constexpr const char* className = "VectorLF3";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("x", &Class::x),
+            schemaField("y", &Class::y),
+            schemaField("z", &Class::z));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::Quaternion>
+{
+    typedef DysonSphereParser::Quaternion Class;
+    static constexpr const char* className = "Quaternion";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("x", &Class::x),
+            schemaField("y", &Class::y),
+            schemaField("z", &Class::z),
+            schemaField("w", &Class::w));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::GameDesc>
+{
+    typedef DysonSphereParser::GameDesc Class;
+    typedef DysonSphereParser::Versions<2> SupportedVersions;
+    static constexpr const char* className = "GameDesc";
+
+    static constexpr auto fields(DysonSphereParser::Versions<2>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("galaxyAlgo", &Class::galaxyAlgo),
+            schemaField("galaxySeed", &Class::galaxySeed),
+            schemaField("starCount", &Class::starCount),
+            schemaField("playerProto", &Class::playerProto),
+            schemaField("resourceMultiplier", &Class::resourceMultiplier),
+            schemaField("numThemeIds", &Class::numThemeIds),
+            schemaArray("themeIds", &Class::themeIds, &Class::numThemeIds));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::GamePrefsData>
+{
+    typedef DysonSphereParser::GamePrefsData Class;
+    typedef DysonSphereParser::Versions<2> SupportedVersions;
+    static constexpr const char* className = "GamePrefsData";
+
+    static constexpr auto fields(DysonSphereParser::Versions<2>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaNested("cameraUPos", &Class::cameraUPos),
+            schemaNested("cameraURot", &Class::cameraURot),
+            schemaField("reformCursorSize", &Class::reformCursorSize),
+            schemaField("numReplicatorMultipliers", &Class::numReplicatorMultipliers),
+            schemaMap("replicatorMultipliers", &Class::replicatorMultipliers, &Class::numReplicatorMultipliers),
+            schemaField("detailPower", &Class::detailPower),
+            schemaField("detailVein", &Class::detailVein),
+            schemaField("detailSpaceGuide", &Class::detailSpaceGuide),
+            schemaField("detailSign", &Class::detailSign),
+            schemaField("detailIcon", &Class::detailIcon),
+            schemaField("numTutorialShowing", &Class::numTutorialShowing),
+            schemaArray("tutorialShowing", &Class::tutorialShowing, &Class::numTutorialShowing));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::TechState>
+{
+    typedef DysonSphereParser::TechState Class;
+    static constexpr const char* className = "TechState";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("techProtoIndex", &Class::techProtoIndex),
+            schemaField("unlocked", &Class::unlocked),
+            schemaField("curLevel", &Class::curLevel),
+            schemaField("maxLevel", &Class::maxLevel),
+            schemaField("hashUploaded", &Class::hashUploaded),
+            schemaField("hashNeeded", &Class::hashNeeded));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::ProductStat>
+{
+    typedef DysonSphereParser::ProductStat Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "ProductStat";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("numCount", &Class::numCount),
+            schemaArray("count", &Class::count, &Class::numCount),
+            schemaField("numCursor", &Class::numCursor),
+            schemaArray("cursor", &Class::cursor, &Class::numCursor),
+            schemaField("numTotal", &Class::numTotal),
+            schemaArray("total", &Class::total, &Class::numTotal),
+            schemaField("itemId", &Class::itemId));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::PowerStat>
+{
+    typedef DysonSphereParser::PowerStat Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "PowerStat";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("numEnergy", &Class::numEnergy),
+            schemaArray("energy", &Class::energy, &Class::numEnergy),
+            schemaField("numCursor", &Class::numCursor),
+            schemaArray("cursor", &Class::cursor, &Class::numCursor),
+            schemaField("numTotal", &Class::numTotal),
+            schemaArray("total", &Class::total, &Class::numTotal));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::MechaLab>
+{
+    typedef DysonSphereParser::MechaLab Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "MechaLab";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("numItemPoints", &Class::numItemPoints),
+            schemaMap("itemPoints", &Class::itemPoints, &Class::numItemPoints));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::MechaDrone>
+{
+    typedef DysonSphereParser::MechaDrone Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "MechaDrone";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("stage", &Class::stage),
+            schemaNested("position", &Class::position),
+            schemaNested("target", &Class::target),
+            schemaNested("forward", &Class::forward),
+            schemaField("speed", &Class::speed),
+            schemaField("movement", &Class::movement),
+            schemaField("targetObject", &Class::targetObject),
+            schemaField("progress", &Class::progress),
+            schemaNested("initialVector", &Class::initialVector));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::PlayerNavigation>
+{
+    typedef DysonSphereParser::PlayerNavigation Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "PlayerNavigation";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("navigating", &Class::navigating),
+            schemaField("naviAstroId", &Class::naviAstroId),
+            schemaNested("naviTarget", &Class::naviTarget),
+            schemaField("useFly", &Class::useFly),
+            schemaField("useSail", &Class::useSail),
+            schemaField("useWarp", &Class::useWarp),
+            schemaEnum<int32_t>("stage", &Class::stage),
+            schemaField("flyThreshold", &Class::flyThreshold),
+            schemaField("sailThreshold", &Class::sailThreshold),
+            schemaField("warpThreshold", &Class::warpThreshold),
+            schemaField("maxSailSpeed", &Class::maxSailSpeed));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::GalacticTransport>
+{
+    typedef DysonSphereParser::GalacticTransport Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "GalacticTransport";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::VeinGroup>
+{
+    typedef DysonSphereParser::VeinGroup Class;
+    static constexpr const char* className = "VeinGroup";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaEnum<int32_t>("type", &Class::type),
+            schemaNested("pos", &Class::pos),
+            schemaField("count", &Class::count),
+            schemaField("amount", &Class::amount));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::EntityData>
+{
+    typedef DysonSphereParser::EntityData Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "EntityData";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("protoId", &Class::protoId),
+            schemaField("modelIndex", &Class::modelIndex),
+            schemaNested("pos", &Class::pos),
+            schemaNested("rot", &Class::rot),
+            schemaField("beltId", &Class::beltId),
+            schemaField("splitterId", &Class::splitterId),
+            schemaField("storageId", &Class::storageId),
+            schemaField("tankId", &Class::tankId),
+            schemaField("minerId", &Class::minerId),
+            schemaField("inserterId", &Class::inserterId),
+            schemaField("assemblerId", &Class::assemblerId),
+            schemaField("fractionateId", &Class::fractionateId),
+            schemaField("ejectorId", &Class::ejectorId),
+            schemaField("siloId", &Class::siloId),
+            schemaField("labId", &Class::labId),
+            schemaField("stationId", &Class::stationId),
+            schemaField("powerNodeId", &Class::powerNodeId),
+            schemaField("powerGenId", &Class::powerGenId),
+            schemaField("powerConId", &Class::powerConId),
+            schemaField("powerAccId", &Class::powerAccId),
+            schemaField("powerExcId", &Class::powerExcId),
+            schemaField("monsterId", &Class::monsterId));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::AnimData>
+{
+    typedef DysonSphereParser::AnimData Class;
+    static constexpr const char* className = "AnimData";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("time", &Class::time),
+            schemaField("prepare_length", &Class::prepare_length),
+            schemaField("working_length", &Class::working_length),
+            schemaField("state", &Class::state),
+            schemaField("power", &Class::power));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::SignData>
+{
+    typedef DysonSphereParser::SignData Class;
+    static constexpr const char* className = "SignData";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("signType", &Class::signType),
+            schemaField("iconType", &Class::iconType),
+            schemaField("iconId0", &Class::iconId0),
+            schemaField("iconId1", &Class::iconId1),
+            schemaField("iconId2", &Class::iconId2),
+            schemaField("iconId3", &Class::iconId3),
+            schemaField("count0", &Class::count0),
+            schemaField("count1", &Class::count1),
+            schemaField("count2", &Class::count2),
+            schemaField("count3", &Class::count3),
+            schemaField("x", &Class::x),
+            schemaField("y", &Class::y),
+            schemaField("z", &Class::z),
+            schemaField("w", &Class::w));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::PrebuildData>
+{
+    typedef DysonSphereParser::PrebuildData Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "PrebuildData";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("protoId", &Class::protoId),
+            schemaField("modelIndex", &Class::modelIndex),
+            schemaNested("pos", &Class::pos),
+            schemaNested("rot", &Class::rot),
+            schemaNested("pos2", &Class::pos2),
+            schemaNested("rot2", &Class::rot2),
+            schemaField("upEntity", &Class::upEntity),
+            schemaField("pickOffset", &Class::pickOffset),
+            schemaField("insertOffset", &Class::insertOffset),
+            schemaField("recipeId", &Class::recipeId),
+            schemaField("filterId", &Class::filterId),
+            schemaField("refCount", &Class::refCount),
+            schemaArray("refArr", &Class::refArr, &Class::refCount));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::VegeData>
+{
+    typedef DysonSphereParser::VegeData Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "VegeData";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("protoId", &Class::protoId),
+            schemaField("modelIndex", &Class::modelIndex),
+            schemaField("hp", &Class::hp),
+            schemaNested("pos", &Class::pos),
+            schemaNested("rot", &Class::rot),
+            schemaNested("scl", &Class::scl));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::VeinData>
+{
+    typedef DysonSphereParser::VeinData Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "VeinData";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaEnum<int16_t>("type", &Class::type),
+            schemaField("modelIndex", &Class::modelIndex),
+            schemaField("groupIndex", &Class::groupIndex),
+            schemaField("amount", &Class::amount),
+            schemaField("productId", &Class::productId),
+            schemaNested("pos", &Class::pos),
+            schemaField("minerCount", &Class::minerCount),
+            schemaField("minerId0", &Class::minerId0),
+            schemaField("minerId1", &Class::minerId1),
+            schemaField("minerId2", &Class::minerId2),
+            schemaField("minerId3", &Class::minerId3));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::Cargo>
+{
+    typedef DysonSphereParser::Cargo Class;
+    static constexpr const char* className = "Cargo";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("item", &Class::item),
+            schemaNested("position", &Class::position),
+            schemaNested("rotation", &Class::rotation));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::BeltComponent>
+{
+    typedef DysonSphereParser::BeltComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "BeltComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("speed", &Class::speed),
+            schemaField("segPathId", &Class::segPathId),
+            schemaField("segIndex", &Class::segIndex),
+            schemaField("segPivotOffset", &Class::segPivotOffset),
+            schemaField("segLength", &Class::segLength),
+            schemaField("outputId", &Class::outputId),
+            schemaField("backInputId", &Class::backInputId),
+            schemaField("leftInputId", &Class::leftInputId),
+            schemaField("rightInputId", &Class::rightInputId));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::SplitterComponent>
+{
+    typedef DysonSphereParser::SplitterComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "SplitterComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("beltA", &Class::beltA),
+            schemaField("beltB", &Class::beltB),
+            schemaField("beltC", &Class::beltC),
+            schemaField("beltD", &Class::beltD),
+            schemaField("input0", &Class::input0),
+            schemaField("input1", &Class::input1),
+            schemaField("input2", &Class::input2),
+            schemaField("input3", &Class::input3),
+            schemaField("output0", &Class::output0),
+            schemaField("output1", &Class::output1),
+            schemaField("output2", &Class::output2),
+            schemaField("output3", &Class::output3),
+            schemaField("inPriority", &Class::inPriority),
+            schemaField("outPriority", &Class::outPriority),
+            schemaField("outFilter", &Class::outFilter));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::TankComponent>
+{
+    typedef DysonSphereParser::TankComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "TankComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("lastTankId", &Class::lastTankId),
+            schemaField("nextTankId", &Class::nextTankId),
+            schemaField("belt0", &Class::belt0),
+            schemaField("belt1", &Class::belt1),
+            schemaField("belt2", &Class::belt2),
+            schemaField("belt3", &Class::belt3),
+            schemaField("isOutput0", &Class::isOutput0),
+            schemaField("isOutput1", &Class::isOutput1),
+            schemaField("isOutput2", &Class::isOutput2),
+            schemaField("isOutput3", &Class::isOutput3),
+            schemaField("fluidStorageCount", &Class::fluidStorageCount),
+            schemaField("currentCount", &Class::currentCount),
+            schemaField("fluidId", &Class::fluidId),
+            schemaField("outputSwitch", &Class::outputSwitch),
+            schemaField("inputSwitch", &Class::inputSwitch),
+            schemaField("isBottom", &Class::isBottom));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::PowerGeneratorComponent>
+{
+    typedef DysonSphereParser::PowerGeneratorComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "PowerGeneratorComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("networkId", &Class::networkId),
+            schemaField("photovoltaic", &Class::photovoltaic),
+            schemaField("wind", &Class::wind),
+            schemaField("gamma", &Class::gamma),
+            schemaField("genEnergyPerTick", &Class::genEnergyPerTick),
+            schemaField("useFuelPerTick", &Class::useFuelPerTick),
+            schemaField("fuelMask", &Class::fuelMask),
+            schemaField("fuelEnergy", &Class::fuelEnergy),
+            schemaField("curFuelId", &Class::curFuelId),
+            schemaField("fuelId", &Class::fuelId),
+            schemaField("fuelCount", &Class::fuelCount),
+            schemaField("fuelHeat", &Class::fuelHeat),
+            schemaField("catalystId", &Class::catalystId),
+            schemaField("catalystPoint", &Class::catalystPoint),
+            schemaField("productId", &Class::productId),
+            schemaField("productCount", &Class::productCount),
+            schemaField("productHeat", &Class::productHeat),
+            schemaField("warmup", &Class::warmup),
+            schemaField("ionEnhance", &Class::ionEnhance),
+            schemaField("x", &Class::x),
+            schemaField("y", &Class::y),
+            schemaField("z", &Class::z));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::PowerNodeComponent>
+{
+    typedef DysonSphereParser::PowerNodeComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "PowerNodeComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("networkId", &Class::networkId),
+            schemaField("isCharger", &Class::isCharger),
+            schemaField("workEnergyPerTick", &Class::workEnergyPerTick),
+            schemaField("idleEnergyPerTick", &Class::idleEnergyPerTick),
+            schemaField("requiredEnergy", &Class::requiredEnergy),
+            schemaNested("powerPoint", &Class::powerPoint),
+            schemaField("connectDistance", &Class::connectDistance),
+            schemaField("coverRadius", &Class::coverRadius));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::PowerConsumerComponent>
+{
+    typedef DysonSphereParser::PowerConsumerComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "PowerConsumerComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("networkId", &Class::networkId),
+            schemaNested("plugPos", &Class::plugPos),
+            schemaField("requiredEnergy", &Class::requiredEnergy),
+            schemaField("servedEnergy", &Class::servedEnergy),
+            schemaField("workEnergyPerTick", &Class::workEnergyPerTick),
+            schemaField("idleEnergyPerTick", &Class::idleEnergyPerTick));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::PowerAccumulatorComponent>
+{
+    typedef DysonSphereParser::PowerAccumulatorComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "PowerAccumulatorComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("networkId", &Class::networkId),
+            schemaField("inputEnergyPerTick", &Class::inputEnergyPerTick),
+            schemaField("outputEnergyPerTick", &Class::outputEnergyPerTick),
+            schemaField("curEnergy", &Class::curEnergy),
+            schemaField("maxEnergy", &Class::maxEnergy));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::PowerExchangerComponent>
+{
+    typedef DysonSphereParser::PowerExchangerComponent Class;
+    typedef DysonSphereParser::Versions<1> SupportedVersions;
+    static constexpr const char* className = "PowerExchangerComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<1>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("networkId", &Class::networkId),
+            schemaField("emptyCount", &Class::emptyCount),
+            schemaField("fullCount", &Class::fullCount),
+            schemaField("targetState", &Class::targetState),
+            schemaField("state", &Class::state),
+            schemaField("energyPerTick", &Class::energyPerTick),
+            schemaField("curPoolEnergy", &Class::curPoolEnergy),
+            schemaField("poolMaxEnergy", &Class::poolMaxEnergy),
+            schemaField("emptyId", &Class::emptyId),
+            schemaField("fullId", &Class::fullId),
+            schemaField("belt0", &Class::belt0),
+            schemaField("belt1", &Class::belt1),
+            schemaField("belt2", &Class::belt2),
+            schemaField("belt3", &Class::belt3),
+            schemaField("isOutput0", &Class::isOutput0),
+            schemaField("isOutput1", &Class::isOutput1),
+            schemaField("isOutput2", &Class::isOutput2),
+            schemaField("isOutput3", &Class::isOutput3),
+            schemaField("outputSlot", &Class::outputSlot),
+            schemaField("inputSlot", &Class::inputSlot),
+            schemaField("outputRectify", &Class::outputRectify),
+            schemaField("inputRectify", &Class::inputRectify));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::PowerNetworkStructures_Node>
+{
+    typedef DysonSphereParser::PowerNetworkStructures_Node Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "PowerNetworkStructures_Node";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("x", &Class::x),
+            schemaField("y", &Class::y),
+            schemaField("z", &Class::z),
+            schemaField("connDistance2", &Class::connDistance2),
+            schemaField("coverRadius2", &Class::coverRadius2),
+            schemaField("genId", &Class::genId),
+            schemaField("accId", &Class::accId),
+            schemaField("excId", &Class::excId),
+            schemaField("numConnIdsForLoad", &Class::numConnIdsForLoad),
+            schemaField("numLineIdsForLoad", &Class::numLineIdsForLoad),
+            schemaField("numConsumers", &Class::numConsumers),
+            schemaArray("connIdsForLoad", &Class::connIdsForLoad, &Class::numConnIdsForLoad),
+            schemaArray("lineIdsForLoad", &Class::lineIdsForLoad, &Class::numLineIdsForLoad),
+            schemaArray("consumers", &Class::consumers, &Class::numConsumers));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::MinerComponent>
+{
+    typedef DysonSphereParser::MinerComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "MinerComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("pcId", &Class::pcId),
+            schemaEnum<int32_t>("type", &Class::type),
+            schemaField("speed", &Class::speed),
+            schemaField("time", &Class::time),
+            schemaField("period", &Class::period),
+            schemaField("insertTarget", &Class::insertTarget),
+            schemaEnum<int32_t>("workstate", &Class::workstate),
+            schemaField("veinCount", &Class::veinCount),
+            schemaArray("veins", &Class::veins, &Class::veinCount),
+            schemaField("currentVeinIndex", &Class::currentVeinIndex),
+            schemaField("minimumVeinAmount", &Class::minimumVeinAmount),
+            schemaField("productId", &Class::productId),
+            schemaField("productCount", &Class::productCount),
+            schemaField("seed", &Class::seed));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::InserterComponent>
+{
+    typedef DysonSphereParser::InserterComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "InserterComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("pcId", &Class::pcId),
+            schemaEnum<int32_t>("stage", &Class::stage),
+            schemaField("speed", &Class::speed),
+            schemaField("time", &Class::time),
+            schemaField("stt", &Class::stt),
+            schemaField("delay", &Class::delay),
+            schemaField("pickTarget", &Class::pickTarget),
+            schemaField("insertTarget", &Class::insertTarget),
+            schemaField("careNeeds", &Class::careNeeds),
+            schemaField("canStack", &Class::canStack),
+            schemaField("pickOffset", &Class::pickOffset),
+            schemaField("insertOffset", &Class::insertOffset),
+            schemaField("filter", &Class::filter),
+            schemaField("itemId", &Class::itemId),
+            schemaField("stackCount", &Class::stackCount),
+            schemaField("stackSize", &Class::stackSize),
+            schemaNested("pos2", &Class::pos2),
+            schemaNested("rot2", &Class::rot2),
+            schemaField("t1", &Class::t1),
+            schemaField("t2", &Class::t2));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::FractionateComponent>
+{
+    typedef DysonSphereParser::FractionateComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "FractionateComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("pcId", &Class::pcId),
+            schemaField("belt0", &Class::belt0),
+            schemaField("belt1", &Class::belt1),
+            schemaField("belt2", &Class::belt2),
+            schemaField("isOutput0", &Class::isOutput0),
+            schemaField("isOutput1", &Class::isOutput1),
+            schemaField("isOutput2", &Class::isOutput2),
+            schemaField("isWorking", &Class::isWorking),
+            schemaField("produceProb", &Class::produceProb),
+            schemaField("need", &Class::need),
+            schemaField("product", &Class::product),
+            schemaField("needCurrCount", &Class::needCurrCount),
+            schemaField("productCurrCount", &Class::productCurrCount),
+            schemaField("oriProductCurrCount", &Class::oriProductCurrCount),
+            schemaField("progress", &Class::progress),
+            schemaField("isRand", &Class::isRand),
+            schemaField("fractionateSuccess", &Class::fractionateSuccess),
+            schemaField("needMaxCount", &Class::needMaxCount),
+            schemaField("productMaxCount", &Class::productMaxCount),
+            schemaField("oriProductMaxCount", &Class::oriProductMaxCount),
+            schemaField("seed", &Class::seed));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::EjectorComponent>
+{
+    typedef DysonSphereParser::EjectorComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "EjectorComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("planetId", &Class::planetId),
+            schemaField("pcId", &Class::pcId),
+            schemaField("direction", &Class::direction),
+            schemaField("time", &Class::time),
+            schemaField("fired", &Class::fired),
+            schemaField("chargeSpend", &Class::chargeSpend),
+            schemaField("coldSpend", &Class::coldSpend),
+            schemaField("bulletId", &Class::bulletId),
+            schemaField("bulletCount", &Class::bulletCount),
+            schemaField("orbitId", &Class::orbitId),
+            schemaField("pivotY", &Class::pivotY),
+            schemaField("muzzleY", &Class::muzzleY),
+            schemaNested("localPosN", &Class::localPosN),
+            schemaField("localAlt", &Class::localAlt),
+            schemaNested("localRot", &Class::localRot),
+            schemaNested("localDir", &Class::localDir));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::SiloComponent>
+{
+    typedef DysonSphereParser::SiloComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "SiloComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("planetId", &Class::planetId),
+            schemaField("pcId", &Class::pcId),
+            schemaField("direction", &Class::direction),
+            schemaField("time", &Class::time),
+            schemaField("fired", &Class::fired),
+            schemaField("chargeSpend", &Class::chargeSpend),
+            schemaField("coldSpend", &Class::coldSpend),
+            schemaField("bulletId", &Class::bulletId),
+            schemaField("bulletCount", &Class::bulletCount),
+            schemaField("autoIndex", &Class::autoIndex),
+            schemaField("hasNode", &Class::hasNode),
+            schemaNested("localPos", &Class::localPos),
+            schemaNested("localRot", &Class::localRot));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::DroneData>
+{
+    typedef DysonSphereParser::DroneData Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "DroneData";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaNested("begin", &Class::begin),
+            schemaNested("end", &Class::end),
+            schemaField("endId", &Class::endId),
+            schemaField("direction", &Class::direction),
+            schemaField("maxt", &Class::maxt),
+            schemaField("t", &Class::t),
+            schemaField("itemId", &Class::itemId),
+            schemaField("itemCount", &Class::itemCount),
+            schemaField("gene", &Class::gene));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::LocalLogisticOrder>
+{
+    typedef DysonSphereParser::LocalLogisticOrder Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "LocalLogisticOrder";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("otherStationId", &Class::otherStationId),
+            schemaField("thisIndex", &Class::thisIndex),
+            schemaField("otherIndex", &Class::otherIndex),
+            schemaField("itemId", &Class::itemId),
+            schemaField("thisOrdered", &Class::thisOrdered),
+            schemaField("otherOrdered", &Class::otherOrdered));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::ShipData>
+{
+    typedef DysonSphereParser::ShipData Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "ShipData";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("stage", &Class::stage),
+            schemaField("planetA", &Class::planetA),
+            schemaField("planetB", &Class::planetB),
+            schemaNested("uPos", &Class::uPos),
+            schemaNested("uVel", &Class::uVel),
+            schemaField("uSpeed", &Class::uSpeed),
+            schemaField("warpState", &Class::warpState),
+            schemaNested("uRot", &Class::uRot),
+            schemaNested("uAngularVel", &Class::uAngularVel),
+            schemaField("uAngularSpeed", &Class::uAngularSpeed),
+            schemaNested("pPosTemp", &Class::pPosTemp),
+            schemaNested("pRotTemp", &Class::pRotTemp),
+            schemaField("otherGId", &Class::otherGId),
+            schemaField("direction", &Class::direction),
+            schemaField("t", &Class::t),
+            schemaField("itemId", &Class::itemId),
+            schemaField("itemCount", &Class::itemCount),
+            schemaField("gene", &Class::gene),
+            schemaField("shipIndex", &Class::shipIndex),
+            schemaField("warperCnt", &Class::warperCnt));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::RemoteLogisticOrder>
+{
+    typedef DysonSphereParser::RemoteLogisticOrder Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "RemoteLogisticOrder";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("otherStationGId", &Class::otherStationGId),
+            schemaField("thisIndex", &Class::thisIndex),
+            schemaField("otherIndex", &Class::otherIndex),
+            schemaField("itemId", &Class::itemId),
+            schemaField("thisOrdered", &Class::thisOrdered),
+            schemaField("otherOrdered", &Class::otherOrdered));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::StationStore>
+{
+    typedef DysonSphereParser::StationStore Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "StationStore";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("itemId", &Class::itemId),
+            schemaField("count", &Class::count),
+            schemaField("localOrder", &Class::localOrder),
+            schemaField("remoteOrder", &Class::remoteOrder),
+            schemaField("max", &Class::max),
+            schemaEnum<int32_t>("localLogic", &Class::localLogic),
+            schemaEnum<int32_t>("remoteLogic", &Class::remoteLogic));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::SlotData>
+{
+    typedef DysonSphereParser::SlotData Class;
+    static constexpr const char* className = "SlotData";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("dir", &Class::dir),
+            schemaField("beltId", &Class::beltId),
+            schemaField("storageIdx", &Class::storageIdx),
+            schemaField("counter", &Class::counter));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::MonsterComponent>
+{
+    typedef DysonSphereParser::MonsterComponent Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "MonsterComponent";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("entityId", &Class::entityId),
+            schemaField("walkSpeed", &Class::walkSpeed),
+            schemaNested("point0", &Class::point0),
+            schemaNested("point1", &Class::point1),
+            schemaNested("point2", &Class::point2),
+            schemaField("direction", &Class::direction),
+            schemaField("stopTime", &Class::stopTime),
+            schemaField("t", &Class::t),
+            schemaField("stopCurrentTime", &Class::stopCurrentTime),
+            schemaEnum<int32_t>("monsterState", &Class::monsterState),
+            schemaField("stepDistance", &Class::stepDistance));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::PlatformSystem>
+{
+    typedef DysonSphereParser::PlatformSystem Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "PlatformSystem";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("reformDataByteCount", &Class::reformDataByteCount),
+            schemaArray("reformData", &Class::reformData, &Class::reformDataByteCount),
+            schemaField("reformOffsetsByteCount", &Class::reformOffsetsByteCount),
+            schemaArray("reformOffsets", &Class::reformOffsets, &Class::reformOffsetsByteCount));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::DysonSail>
+{
+    typedef DysonSphereParser::DysonSail Class;
+    static constexpr const char* className = "DysonSail";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("st", &Class::st),
+            schemaNested("p", &Class::p),
+            schemaNested("v", &Class::v),
+            schemaField("gs", &Class::gs));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::DysonSailInfo>
+{
+    typedef DysonSphereParser::DysonSailInfo Class;
+    static constexpr const char* className = "DysonSailInfo";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("orbit", &Class::orbit),
+            schemaField("node", &Class::node),
+            schemaField("kill", &Class::kill),
+            schemaNested("posr", &Class::posr));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::SailOrbit>
+{
+    typedef DysonSphereParser::SailOrbit Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "SailOrbit";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("radius", &Class::radius),
+            schemaNested("rotation", &Class::rotation),
+            schemaNested("up", &Class::up),
+            schemaField("count", &Class::count),
+            schemaField("enabled", &Class::enabled));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::ExpiryOrder>
+{
+    typedef DysonSphereParser::ExpiryOrder Class;
+    static constexpr const char* className = "ExpiryOrder";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("time", &Class::time),
+            schemaField("index", &Class::index));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::AbsorbOrder>
+{
+    typedef DysonSphereParser::AbsorbOrder Class;
+    static constexpr const char* className = "AbsorbOrder";
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(
+            schemaField("time", &Class::time),
+            schemaField("index", &Class::index),
+            schemaField("layer", &Class::layer),
+            schemaField("node", &Class::node));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::SailBullet>
+{
+    typedef DysonSphereParser::SailBullet Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "SailBullet";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("t", &Class::t),
+            schemaField("maxt", &Class::maxt),
+            schemaField("state", &Class::state),
+            schemaNested("rBegin", &Class::rBegin),
+            schemaNested("rEnd", &Class::rEnd),
+            schemaNested("lBegin", &Class::lBegin),
+            schemaNested("uEndVel", &Class::uEndVel),
+            schemaNested("uBegin", &Class::uBegin),
+            schemaNested("uEnd", &Class::uEnd));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::DysonNode>
+{
+    typedef DysonSphereParser::DysonNode Class;
+    typedef DysonSphereParser::Versions<4> SupportedVersions;
+    static constexpr const char* className = "DysonNode";
+
+    static constexpr auto fields(DysonSphereParser::Versions<4>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("protoId", &Class::protoId),
+            schemaField("layerId", &Class::layerId),
+            schemaField("use", &Class::use),
+            schemaField("reserved", &Class::reserved),
+            schemaNested("pos", &Class::pos),
+            schemaField("sp", &Class::sp),
+            schemaField("spMax", &Class::spMax),
+            schemaField("spOrdered", &Class::spOrdered),
+            schemaField("cpOrdered", &Class::cpOrdered),
+            schemaField("rid", &Class::rid),
+            schemaField("frameTurn", &Class::frameTurn),
+            schemaField("shellTurn", &Class::shellTurn),
+            schemaField("_spReq", &Class::_spReq),
+            schemaField("_cpReq", &Class::_cpReq));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::DysonFrame>
+{
+    typedef DysonSphereParser::DysonFrame Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "DysonFrame";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("protoId", &Class::protoId),
+            schemaField("layerId", &Class::layerId),
+            schemaField("reserved", &Class::reserved),
+            schemaField("nodeId", &Class::nodeId),
+            schemaField("nodeId2", &Class::nodeId2),
+            schemaField("euler", &Class::euler),
+            schemaField("spA", &Class::spA),
+            schemaField("spB", &Class::spB),
+            schemaField("spMax", &Class::spMax));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::DysonRocket>
+{
+    typedef DysonSphereParser::DysonRocket Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "DysonRocket";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("nodeLayerId", &Class::nodeLayerId),
+            schemaField("nodeId", &Class::nodeId),
+            schemaField("planetId", &Class::planetId),
+            schemaField("t", &Class::t),
+            schemaField("uSpeed", &Class::uSpeed),
+            schemaNested("uPos", &Class::uPos),
+            schemaNested("uRot", &Class::uRot),
+            schemaNested("uVel", &Class::uVel),
+            schemaNested("launch", &Class::launch));
+    }
+};
+
+template<>
+struct DysonSphereSchema<DysonSphereParser::DysonNodeRData>
+{
+    typedef DysonSphereParser::DysonNodeRData Class;
+    typedef DysonSphereParser::Versions<0> SupportedVersions;
+    static constexpr const char* className = "DysonNodeRData";
+
+    static constexpr auto fields(DysonSphereParser::Versions<0>)
+    {
+        return std::make_tuple(
+            schemaVersion("version", &Class::version),
+            schemaField("id", &Class::id),
+            schemaField("layerId", &Class::layerId),
+            schemaNested("pos", &Class::pos),
+            schemaField("angularVel", &Class::angularVel),
+            schemaNested("layerRot", &Class::layerRot));
+    }
+};
+// The hand-maintained recordSize constants drive skipv().  Check them against the tables.
+static_assert(schemaFixedSize<DysonSphereParser::VeinGroup>() == DysonSphereParser::VeinGroup::recordSize, "VeinGroup::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::EntityData>() == DysonSphereParser::EntityData::recordSize, "EntityData::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::AnimData>() == DysonSphereParser::AnimData::recordSize, "AnimData::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::SignData>() == DysonSphereParser::SignData::recordSize, "SignData::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::VegeData>() == DysonSphereParser::VegeData::recordSize, "VegeData::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::VeinData>() == DysonSphereParser::VeinData::recordSize, "VeinData::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::Cargo>() == DysonSphereParser::Cargo::recordSize, "Cargo::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::BeltComponent>() == DysonSphereParser::BeltComponent::recordSize, "BeltComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::SplitterComponent>() == DysonSphereParser::SplitterComponent::recordSize, "SplitterComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::TankComponent>() == DysonSphereParser::TankComponent::recordSize, "TankComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::PowerGeneratorComponent>() == DysonSphereParser::PowerGeneratorComponent::recordSize, "PowerGeneratorComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::PowerNodeComponent>() == DysonSphereParser::PowerNodeComponent::recordSize, "PowerNodeComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::PowerConsumerComponent>() == DysonSphereParser::PowerConsumerComponent::recordSize, "PowerConsumerComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::PowerAccumulatorComponent>() == DysonSphereParser::PowerAccumulatorComponent::recordSize, "PowerAccumulatorComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::PowerExchangerComponent>() == DysonSphereParser::PowerExchangerComponent::recordSize, "PowerExchangerComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::InserterComponent>() == DysonSphereParser::InserterComponent::recordSize, "InserterComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::FractionateComponent>() == DysonSphereParser::FractionateComponent::recordSize, "FractionateComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::EjectorComponent>() == DysonSphereParser::EjectorComponent::recordSize, "EjectorComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::SiloComponent>() == DysonSphereParser::SiloComponent::recordSize, "SiloComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::DroneData>() == DysonSphereParser::DroneData::recordSize, "DroneData::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::LocalLogisticOrder>() == DysonSphereParser::LocalLogisticOrder::recordSize, "LocalLogisticOrder::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::ShipData>() == DysonSphereParser::ShipData::recordSize, "ShipData::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::RemoteLogisticOrder>() == DysonSphereParser::RemoteLogisticOrder::recordSize, "RemoteLogisticOrder::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::StationStore>() == DysonSphereParser::StationStore::recordSize, "StationStore::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::SlotData>() == DysonSphereParser::SlotData::recordSize, "SlotData::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::MonsterComponent>() == DysonSphereParser::MonsterComponent::recordSize, "MonsterComponent::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::DysonSail>() == DysonSphereParser::DysonSail::recordSize, "DysonSail::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::DysonSailInfo>() == DysonSphereParser::DysonSailInfo::recordSize, "DysonSailInfo::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::SailOrbit>() == DysonSphereParser::SailOrbit::recordSize, "SailOrbit::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::ExpiryOrder>() == DysonSphereParser::ExpiryOrder::recordSize, "ExpiryOrder::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::AbsorbOrder>() == DysonSphereParser::AbsorbOrder::recordSize, "AbsorbOrder::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::SailBullet>() == DysonSphereParser::SailBullet::recordSize, "SailBullet::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::DysonNode>() == DysonSphereParser::DysonNode::recordSize, "DysonNode::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::DysonFrame>() == DysonSphereParser::DysonFrame::recordSize, "DysonFrame::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::DysonRocket>() == DysonSphereParser::DysonRocket::recordSize, "DysonRocket::recordSize does not match its schema");
+static_assert(schemaFixedSize<DysonSphereParser::DysonNodeRData>() == DysonSphereParser::DysonNodeRData::recordSize, "DysonNodeRData::recordSize does not match its schema");
@@ -0,0 +1,1256 @@
+//
+// Copyright (c) 2021, Aaron Shumate
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE.txt file in the root directory of this source tree.
+//
+// Dyson Sphere Program is developed by Youthcat Studio and published by Gamera Game.
+
+#pragma once
+
+#include <fstream>
+#include <tuple>
+#include "DysonSphereParser.h"
+
+// Snapshot sidecars hold a parsed GameSave as it is laid out in memory, so loading one is a block
+// copy per pool instead of a decode per field.  Trivially copyable classes, which are most of the
+// pool records, are stored as raw bytes.  The classes below hold strings, pools or maps and list
+// their members instead.  Derived data, like EntityTable and EntityIndex, is rebuilt after loading.
+// The sidecar is a cache for this machine and build: it is written in host byte order and layout,
+// and every raw pool records its element size so that a changed record is caught on loading.
+template<typename CLASS>
+struct DysonSphereSnapshot;
+
+template<typename TYPE>
+void snapshotWrite(std::ofstream& file, const TYPE& value);
+void snapshotWrite(std::ofstream& file, const std::string& value);
+template<typename TYPE, typename ALLOCATOR>
+void snapshotWrite(std::ofstream& file, const std::vector<TYPE, ALLOCATOR>& vect);
+template<typename KEY, typename VALUE>
+void snapshotWrite(std::ofstream& file, const std::map<KEY, VALUE>& map);
+void snapshotWrite(std::ofstream& file, const std::vector<DysonSphereParser::PlanetFactoryHandle>& factories);
+
+template<typename TYPE>
+void snapshotRead(DysonSphereParser::InputStream& strm, TYPE& value);
+void snapshotRead(DysonSphereParser::InputStream& strm, std::string& value);
+template<typename TYPE, typename ALLOCATOR>
+void snapshotRead(DysonSphereParser::InputStream& strm, std::vector<TYPE, ALLOCATOR>& vect);
+template<typename KEY, typename VALUE>
+void snapshotRead(DysonSphereParser::InputStream& strm, std::map<KEY, VALUE>& map);
+void snapshotRead(DysonSphereParser::InputStream& strm, std::vector<DysonSphereParser::PlanetFactoryHandle>& factories);
+
+template<typename TYPE>
+void snapshotWrite(std::ofstream& file, const TYPE& value)
+{
+    if constexpr (std::is_trivially_copyable<TYPE>::value)
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    else
+        std::apply([&](const auto... members) { (snapshotWrite(file, value.*members), ...); }, DysonSphereSnapshot<TYPE>::members());
+}
+
+inline void snapshotWrite(std::ofstream& file, const std::string& value)
+{
+    snapshotWrite(file, static_cast<int32_t>(value.size()));
+    file.write(value.data(), value.size());
+}
+
+// Raw pools are stored as count, element size and the elements as one block.
+template<typename TYPE, typename ALLOCATOR>
+void snapshotWrite(std::ofstream& file, const std::vector<TYPE, ALLOCATOR>& vect)
+{
+    snapshotWrite(file, static_cast<int32_t>(vect.size()));
+    if constexpr (std::is_trivially_copyable<TYPE>::value)
+    {
+        snapshotWrite(file, static_cast<int32_t>(sizeof(TYPE)));
+        file.write(reinterpret_cast<const char*>(vect.data()), vect.size() * sizeof(TYPE));
+    }
+    else
+    {
+        for (const auto& element : vect)
+            snapshotWrite(file, element);
+    }
+}
+
+template<typename KEY, typename VALUE>
+void snapshotWrite(std::ofstream& file, const std::map<KEY, VALUE>& map)
+{
+    snapshotWrite(file, static_cast<int32_t>(map.size()));
+    for (const auto& entry : map)
+    {
+        snapshotWrite(file, entry.first);
+        snapshotWrite(file, entry.second);
+    }
+}
+
+// Lazy handles are loaded here, so the snapshot always holds every factory.
+inline void snapshotWrite(std::ofstream& file, const std::vector<DysonSphereParser::PlanetFactoryHandle>& factories)
+{
+    snapshotWrite(file, static_cast<int32_t>(factories.size()));
+    for (const auto& factory : factories)
+    {
+        snapshotWrite(file, factory.offset);
+        snapshotWrite(file, factory.length);
+        snapshotWrite(file, *factory);
+    }
+}
+
+template<typename TYPE>
+void snapshotRead(DysonSphereParser::InputStream& strm, TYPE& value)
+{
+    if constexpr (std::is_trivially_copyable<TYPE>::value)
+        strm.read(reinterpret_cast<char*>(&value), sizeof(value));
+    else
+        std::apply([&](const auto... members) { (snapshotRead(strm, value.*members), ...); }, DysonSphereSnapshot<TYPE>::members());
+}
+
+inline void snapshotRead(DysonSphereParser::InputStream& strm, std::string& value)
+{
+    int32_t length = 0;
+    snapshotRead(strm, length);
+    if (!strm.checkCount(length, 1, "Snapshot", "string"))
+        return;
+    value.resize(length);
+    strm.read(&value[0], length);
+}
+
+template<typename TYPE, typename ALLOCATOR>
+void snapshotRead(DysonSphereParser::InputStream& strm, std::vector<TYPE, ALLOCATOR>& vect)
+{
+    int32_t size = 0;
+    snapshotRead(strm, size);
+    if constexpr (std::is_trivially_copyable<TYPE>::value)
+    {
+        int32_t elementSize = 0;
+        snapshotRead(strm, elementSize);
+        if (elementSize != static_cast<int32_t>(sizeof(TYPE)))
+        {
+            strm.fail("Snapshot", "elementSize");
+            return;
+        }
+        if (!strm.checkCount(size, sizeof(TYPE), "Snapshot", "pool"))
+            return;
+        vect.resize(size);
+        strm.read(reinterpret_cast<char*>(vect.data()), size * static_cast<int64_t>(sizeof(TYPE)));
+    }
+    else
+    {
+        if (!strm.checkCount(size, 1, "Snapshot", "pool"))
+            return;
+        vect.resize(size);
+        for (auto& element : vect)
+            snapshotRead(strm, element);
+    }
+}
+
+template<typename KEY, typename VALUE>
+void snapshotRead(DysonSphereParser::InputStream& strm, std::map<KEY, VALUE>& map)
+{
+    int32_t size = 0;
+    snapshotRead(strm, size);
+    if (!strm.checkCount(size, sizeof(KEY) + sizeof(VALUE), "Snapshot", "map"))
+        return;
+    map.clear();
+    for (int32_t i = 0; i < size; ++i)
+    {
+        KEY key;
+        snapshotRead(strm, key);
+        snapshotRead(strm, map[key]);
+    }
+}
+
+inline void snapshotRead(DysonSphereParser::InputStream& strm, std::vector<DysonSphereParser::PlanetFactoryHandle>& factories)
+{
+    int32_t size = 0;
+    snapshotRead(strm, size);
+    if (!strm.checkCount(size, 1, "Snapshot", "factories"))
+        return;
+    factories.clear();
+    for (int32_t i = 0; i < size; ++i)
+    {
+        int64_t offset = 0;
+        int64_t length = 0;
+        snapshotRead(strm, offset);
+        snapshotRead(strm, length);
+        DysonSphereParser::ArenaScope scope(DysonSphereParser::MonotonicArena::createCurrentChild());
+        const auto factory = std::make_shared<DysonSphereParser::PlanetFactory>();
+        snapshotRead(strm, *factory);
+        factories.emplace_back(factory);
+        factories.back().offset = offset;
+        factories.back().length = length;
+    }
+}
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::GameDesc>
+{
+    typedef DysonSphereParser::GameDesc Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::galaxyAlgo,
+            &Class::galaxySeed,
+            &Class::starCount,
+            &Class::playerProto,
+            &Class::resourceMultiplier,
+            &Class::numThemeIds,
+            &Class::themeIds);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::GamePrefsData>
+{
+    typedef DysonSphereParser::GamePrefsData Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::cameraUPos,
+            &Class::cameraURot,
+            &Class::reformCursorSize,
+            &Class::numReplicatorMultipliers,
+            &Class::replicatorMultipliers,
+            &Class::detailPower,
+            &Class::detailVein,
+            &Class::detailSpaceGuide,
+            &Class::detailSign,
+            &Class::detailIcon,
+            &Class::numTutorialShowing,
+            &Class::tutorialShowing);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::GameHistoryData>
+{
+    typedef DysonSphereParser::GameHistoryData Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::numRecipeUnlocked,
+            &Class::recipeUnlocked,
+            &Class::numTutorialUnlocked,
+            &Class::tutorialUnlocked,
+            &Class::numFeatureKeys,
+            &Class::featureKeys,
+            &Class::numTechState,
+            &Class::techStates,
+            &Class::autoManageLabItems,
+            &Class::currentTech,
+            &Class::numTechQueue,
+            &Class::techQueue,
+            &Class::universeObserveLevel,
+            &Class::solarSailLife,
+            &Class::solarEnergyLossRate,
+            &Class::useIonLayer,
+            &Class::inserterStackCount,
+            &Class::logisticDroneSpeed,
+            &Class::logisticDroneSpeedScale,
+            &Class::logisticDroneCarries,
+            &Class::logisticShipSailSpeed,
+            &Class::logisticShipWarpSpeed,
+            &Class::logisticShipSpeedScale,
+            &Class::logisticShipWarpDrive,
+            &Class::logisticShipCarries,
+            &Class::miningCostRate,
+            &Class::miningSpeedScale,
+            &Class::storageLevel,
+            &Class::labLevel,
+            &Class::techSpeed,
+            &Class::dysonNodeLatitude,
+            &Class::universeMatrixPointUploaded,
+            &Class::missionAccomplished);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::ProductStat>
+{
+    typedef DysonSphereParser::ProductStat Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::numCount,
+            &Class::count,
+            &Class::numCursor,
+            &Class::cursor,
+            &Class::numTotal,
+            &Class::total,
+            &Class::itemId);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::PowerStat>
+{
+    typedef DysonSphereParser::PowerStat Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::numEnergy,
+            &Class::energy,
+            &Class::numCursor,
+            &Class::cursor,
+            &Class::numTotal,
+            &Class::total,
+            &Class::itemId);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::FactoryProductionStat>
+{
+    typedef DysonSphereParser::FactoryProductionStat Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::productCapacity,
+            &Class::productCursor,
+            &Class::productPool,
+            &Class::numPowerPool,
+            &Class::powerPool,
+            &Class::numProductIndices,
+            &Class::productIndices,
+            &Class::energyConsumption);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::ProductionStatistics>
+{
+    typedef DysonSphereParser::ProductionStatistics Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::numFactoryStatPool,
+            &Class::factoryStatPool,
+            &Class::numFirstCreateIds,
+            &Class::firstCreateIds,
+            &Class::numFavoriteIds,
+            &Class::favoriteIds);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::GameStatData>
+{
+    typedef DysonSphereParser::GameStatData Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::numTechHashedHistory,
+            &Class::techHashedHistory,
+            &Class::production);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::StorageComponent>
+{
+    typedef DysonSphereParser::StorageComponent Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::entityId,
+            &Class::previous,
+            &Class::next,
+            &Class::bottom,
+            &Class::top,
+            &Class::type,
+            &Class::gridSize,
+            &Class::bans,
+            &Class::grids);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::ForgeTask>
+{
+    typedef DysonSphereParser::ForgeTask Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::recipeId,
+            &Class::count,
+            &Class::tick,
+            &Class::tickSpend,
+            &Class::numItem,
+            &Class::numProduct,
+            &Class::itemIds,
+            &Class::itemCounts,
+            &Class::served,
+            &Class::productIds,
+            &Class::productCounts,
+            &Class::produced,
+            &Class::parentTaskIndex);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::MechaForge>
+{
+    typedef DysonSphereParser::MechaForge Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::numTasks,
+            &Class::tasks);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::MechaLab>
+{
+    typedef DysonSphereParser::MechaLab Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::numItemPoints,
+            &Class::itemPoints);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::Mecha>
+{
+    typedef DysonSphereParser::Mecha Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::coreEnergyCap,
+            &Class::coreEnergy,
+            &Class::corePowerGen,
+            &Class::reactorPowerGen,
+            &Class::reactorEnergy,
+            &Class::reactorItemId,
+            &Class::reactorStorage,
+            &Class::warpStorage,
+            &Class::walkPower,
+            &Class::jumpEnergy,
+            &Class::thrustPowerPerAcc,
+            &Class::warpKeepingPowerPerSpeed,
+            &Class::warpStartPowerPerSpeed,
+            &Class::miningPower,
+            &Class::replicatePower,
+            &Class::researchPower,
+            &Class::droneEjectEnergy,
+            &Class::droneEnergyPerMeter,
+            &Class::coreLevel,
+            &Class::thrusterLevel,
+            &Class::miningSpeed,
+            &Class::replicateSpeed,
+            &Class::walkSpeed,
+            &Class::jumpSpeed,
+            &Class::maxSailSpeed,
+            &Class::maxWarpSpeed,
+            &Class::buildArea,
+            &Class::forge,
+            &Class::lab,
+            &Class::droneCount,
+            &Class::droneSpeed,
+            &Class::droneMovement,
+            &Class::drones);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::Player>
+{
+    typedef DysonSphereParser::Player Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::planetId,
+            &Class::position,
+            &Class::uPosition,
+            &Class::uRotation,
+            &Class::movementState,
+            &Class::warpState,
+            &Class::warpCommand,
+            &Class::uVelocity,
+            &Class::inhandItemId,
+            &Class::inhandItemCount,
+            &Class::mecha,
+            &Class::package,
+            &Class::navigation,
+            &Class::sandCount);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::PlanetData>
+{
+    typedef DysonSphereParser::PlanetData Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::modDataByteCount,
+            &Class::modData,
+            &Class::numVeinAmounts,
+            &Class::veinAmounts,
+            &Class::numVeinGroups,
+            &Class::veinGroups);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::PrebuildData>
+{
+    typedef DysonSphereParser::PrebuildData Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::protoId,
+            &Class::modelIndex,
+            &Class::pos,
+            &Class::rot,
+            &Class::pos2,
+            &Class::rot2,
+            &Class::upEntity,
+            &Class::pickOffset,
+            &Class::insertOffset,
+            &Class::recipeId,
+            &Class::filterId,
+            &Class::refCount,
+            &Class::refArr);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::CargoContainer>
+{
+    typedef DysonSphereParser::CargoContainer Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::poolCapacity,
+            &Class::cursor,
+            &Class::recycleBegin,
+            &Class::recycleEnd,
+            &Class::cargoPool,
+            &Class::recycleIds);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::CargoPath>
+{
+    typedef DysonSphereParser::CargoPath Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::capacity,
+            &Class::bufferLength,
+            &Class::chunkCapacity,
+            &Class::chunkCount,
+            &Class::updateLen,
+            &Class::closed,
+            &Class::outputPathIdForImport,
+            &Class::outputIndex,
+            &Class::numBelts,
+            &Class::numInputPaths,
+            &Class::buffer,
+            &Class::chunks,
+            &Class::pointPos,
+            &Class::pointRot,
+            &Class::belts,
+            &Class::inputPaths);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::CargoTraffic>
+{
+    typedef DysonSphereParser::CargoTraffic Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::beltCursor,
+            &Class::beltCapacity,
+            &Class::beltRecycleCursor,
+            &Class::splitterCursor,
+            &Class::splitterCapacity,
+            &Class::splitterRecycleCursor,
+            &Class::pathCursor,
+            &Class::pathCapacity,
+            &Class::pathRecycleCursor,
+            &Class::beltPool,
+            &Class::beltRecycle,
+            &Class::splitterPool,
+            &Class::splitterRecycle,
+            &Class::cargoPathIndex,
+            &Class::pathPool,
+            &Class::pathRecycle);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::FactoryStorage>
+{
+    typedef DysonSphereParser::FactoryStorage Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::storageCursor,
+            &Class::storageCapacity,
+            &Class::storageRecycleCursor,
+            &Class::storagePoolIndex,
+            &Class::storagePoolSize,
+            &Class::storagePool,
+            &Class::storageRecycle,
+            &Class::tankCapacity,
+            &Class::tankCursor,
+            &Class::tankRecycleCursor,
+            &Class::tankPool,
+            &Class::tankRecycle);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::PowerNetworkStructures_Node>
+{
+    typedef DysonSphereParser::PowerNetworkStructures_Node Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::x,
+            &Class::y,
+            &Class::z,
+            &Class::connDistance2,
+            &Class::coverRadius2,
+            &Class::genId,
+            &Class::accId,
+            &Class::excId,
+            &Class::numConnIdsForLoad,
+            &Class::numLineIdsForLoad,
+            &Class::numConsumers,
+            &Class::connIdsForLoad,
+            &Class::lineIdsForLoad,
+            &Class::consumers);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::PowerNetwork>
+{
+    typedef DysonSphereParser::PowerNetwork Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::numNodes,
+            &Class::numConsumers,
+            &Class::numGenerators,
+            &Class::numAccumulators,
+            &Class::numExchangers,
+            &Class::nodes,
+            &Class::consumers,
+            &Class::generators,
+            &Class::accumulators,
+            &Class::exchangers);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::PowerSystem>
+{
+    typedef DysonSphereParser::PowerSystem Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::generatorCapacity,
+            &Class::genCursor,
+            &Class::genRecycleCursor,
+            &Class::genPool,
+            &Class::genRecycle,
+            &Class::nodeCapacity,
+            &Class::nodeCursor,
+            &Class::nodeRecycleCursor,
+            &Class::nodePool,
+            &Class::nodeRecycle,
+            &Class::consumerCapacity,
+            &Class::consumerCursor,
+            &Class::consumerRecycleCursor,
+            &Class::consumerPool,
+            &Class::consumerRecycle,
+            &Class::accumulatorCapacity,
+            &Class::accCursor,
+            &Class::accRecycleCursor,
+            &Class::accPool,
+            &Class::accRecycle,
+            &Class::exchangerCapacity,
+            &Class::excCursor,
+            &Class::excRecycleCursor,
+            &Class::excPool,
+            &Class::excRecycle,
+            &Class::networkCapacity,
+            &Class::netCursor,
+            &Class::netRecycleCursor,
+            &Class::powerNetworkIncludedFlag,
+            &Class::netPool,
+            &Class::netRecycle);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::MinerComponent>
+{
+    typedef DysonSphereParser::MinerComponent Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::entityId,
+            &Class::pcId,
+            &Class::type,
+            &Class::speed,
+            &Class::time,
+            &Class::period,
+            &Class::insertTarget,
+            &Class::workstate,
+            &Class::veinCount,
+            &Class::veins,
+            &Class::currentVeinIndex,
+            &Class::minimumVeinAmount,
+            &Class::productId,
+            &Class::productCount,
+            &Class::seed);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::AssemblerComponent>
+{
+    typedef DysonSphereParser::AssemblerComponent Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::entityId,
+            &Class::pcId,
+            &Class::replicating,
+            &Class::outputing,
+            &Class::speed,
+            &Class::time,
+            &Class::recipeId,
+            &Class::recipeType,
+            &Class::timeSpend,
+            &Class::numRequires,
+            &Class::requires,
+            &Class::numRequireCounts,
+            &Class::requireCounts,
+            &Class::numServed,
+            &Class::served,
+            &Class::numNeeds,
+            &Class::needs,
+            &Class::numProducts,
+            &Class::products,
+            &Class::numProductCounts,
+            &Class::productCounts,
+            &Class::numProduced,
+            &Class::produced);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::LabComponent>
+{
+    typedef DysonSphereParser::LabComponent Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::entityId,
+            &Class::pcId,
+            &Class::nextLabId,
+            &Class::replicating,
+            &Class::outputing,
+            &Class::time,
+            &Class::hashBytes,
+            &Class::researchMode,
+            &Class::recipeId,
+            &Class::techId,
+            &Class::timeSpend,
+            &Class::numRequires,
+            &Class::requires,
+            &Class::numRequireCounts,
+            &Class::requireCounts,
+            &Class::numServed,
+            &Class::served,
+            &Class::numNeeds,
+            &Class::needs,
+            &Class::numProducts,
+            &Class::products,
+            &Class::numProductCounts,
+            &Class::productCounts,
+            &Class::numProduced,
+            &Class::produced,
+            &Class::numMatrixPoints,
+            &Class::matrixPoints,
+            &Class::numMatrixServed,
+            &Class::matrixServed);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::FactorySystem>
+{
+    typedef DysonSphereParser::FactorySystem Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::minerCapacity,
+            &Class::minerCursor,
+            &Class::minerRecycleCursor,
+            &Class::minerPool,
+            &Class::minerRecycle,
+            &Class::inserterCapacity,
+            &Class::inserterCursor,
+            &Class::inserterRecycleCursor,
+            &Class::inserterPool,
+            &Class::inserterRecycle,
+            &Class::assemblerCapacity,
+            &Class::assemblerCursor,
+            &Class::assemblerRecycleCursor,
+            &Class::assemblerPool,
+            &Class::assemblerRecycle,
+            &Class::fractionateCapacity,
+            &Class::fractionateCursor,
+            &Class::fractionateRecycleCursor,
+            &Class::fractionatePool,
+            &Class::fractionateRecycle,
+            &Class::ejectorCapacity,
+            &Class::ejectorCursor,
+            &Class::ejectorRecycleCursor,
+            &Class::ejectorPool,
+            &Class::ejectorRecycle,
+            &Class::siloCapacity,
+            &Class::siloCursor,
+            &Class::siloRecycleCursor,
+            &Class::siloPool,
+            &Class::siloRecycle,
+            &Class::labCapacity,
+            &Class::labCursor,
+            &Class::labRecycleCursor,
+            &Class::labPool,
+            &Class::labRecycle);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::StationComponent>
+{
+    typedef DysonSphereParser::StationComponent Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::gid,
+            &Class::entityId,
+            &Class::planetId,
+            &Class::pcId,
+            &Class::gene,
+            &Class::droneDock,
+            &Class::shipDockPos,
+            &Class::shipDockRot,
+            &Class::isStellar,
+            &Class::nameIsIncludedFlag,
+            &Class::name,
+            &Class::energy,
+            &Class::energyPerTick,
+            &Class::energyMax,
+            &Class::warperCount,
+            &Class::warperMaxCount,
+            &Class::idleDroneCount,
+            &Class::workDroneCount,
+            &Class::workDroneArraySize,
+            &Class::workDroneDatas,
+            &Class::workDroneOrders,
+            &Class::idleShipCount,
+            &Class::workShipCount,
+            &Class::idleShipIndices,
+            &Class::workShipIndices,
+            &Class::arraySize,
+            &Class::workShipDatas,
+            &Class::workShipOrders,
+            &Class::numStorage,
+            &Class::storage,
+            &Class::numSlots,
+            &Class::slots,
+            &Class::localPairProcess,
+            &Class::remotePairProcess,
+            &Class::nextShipIndex,
+            &Class::isCollector,
+            &Class::numCollectionIds,
+            &Class::collectionIds,
+            &Class::numCollectionPerTick,
+            &Class::collectionPerTick,
+            &Class::numCurrentCollections,
+            &Class::currentCollections,
+            &Class::collectSpeed,
+            &Class::tripRangeDrones,
+            &Class::tripRangeShips,
+            &Class::includeOrbitCollector,
+            &Class::warpEnableDist,
+            &Class::warperNecessary,
+            &Class::deliveryDrones,
+            &Class::deliveryShips);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::PlanetTransport>
+{
+    typedef DysonSphereParser::PlanetTransport Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::stationCursor,
+            &Class::stationCapacity,
+            &Class::stationRecycleCursor,
+            &Class::stationIndex,
+            &Class::stationPool,
+            &Class::stationRecycle);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::MonsterSystem>
+{
+    typedef DysonSphereParser::MonsterSystem Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::monsterCapacity,
+            &Class::monsterCursor,
+            &Class::monsterRecycleCursor,
+            &Class::monsterPool,
+            &Class::monsterRecycle);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::PlatformSystem>
+{
+    typedef DysonSphereParser::PlatformSystem Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::reformDataByteCount,
+            &Class::reformData,
+            &Class::reformOffsetsByteCount,
+            &Class::reformOffsets);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::PlanetFactory>
+{
+    typedef DysonSphereParser::PlanetFactory Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::planetId,
+            &Class::planet,
+            &Class::entityCapacity,
+            &Class::entityCursor,
+            &Class::entityRecycleCursor,
+            &Class::entityPool,
+            &Class::entityAnimPool,
+            &Class::entitySignPool,
+            &Class::entityConnPool,
+            &Class::entityRecycle,
+            &Class::prebuildCapacity,
+            &Class::prebuildCursor,
+            &Class::prebuildRecycleCursor,
+            &Class::prebuildPool,
+            &Class::prebuildConnPool,
+            &Class::prebuildRecycle,
+            &Class::vegeCapacity,
+            &Class::vegeCursor,
+            &Class::vegeRecycleCursor,
+            &Class::vegePool,
+            &Class::vegeRecycle,
+            &Class::veinCapacity,
+            &Class::veinCursor,
+            &Class::veinRecycleCursor,
+            &Class::veinPool,
+            &Class::veinRecycle,
+            &Class::veinAnimPool,
+            &Class::cargoContainer,
+            &Class::cargoTraffic,
+            &Class::factoryStorage,
+            &Class::powerSystem,
+            &Class::factorySystem,
+            &Class::transport,
+            &Class::monsterSystem,
+            &Class::platformSystem);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::DysonSwarm>
+{
+    typedef DysonSphereParser::DysonSwarm Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::randSeed,
+            &Class::sailCapacity,
+            &Class::sailCursor,
+            &Class::sailRecycleCursor,
+            &Class::sailPoolForSave,
+            &Class::sailInfos,
+            &Class::sailRecycle,
+            &Class::orbitCapacity,
+            &Class::orbitCursor,
+            &Class::orbits,
+            &Class::numExpiryOrder,
+            &Class::expiryCursor,
+            &Class::expiryEnding,
+            &Class::expiryOrder,
+            &Class::numAbsorbOrder,
+            &Class::absorbCursor,
+            &Class::absorbEnding,
+            &Class::absorbOrder,
+            &Class::bulletCapacity,
+            &Class::bulletCursor,
+            &Class::bulletRecycleCursor,
+            &Class::bulletPool,
+            &Class::bulletRecycle);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::DysonShell>
+{
+    typedef DysonSphereParser::DysonShell Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::protoId,
+            &Class::layerId,
+            &Class::randSeed,
+            &Class::numPolygon,
+            &Class::polygon,
+            &Class::numDysonNode,
+            &Class::nodeId,
+            &Class::vertexCount,
+            &Class::triangleCount,
+            &Class::numVerts,
+            &Class::verts,
+            &Class::numPqArr,
+            &Class::pqArr,
+            &Class::numTris,
+            &Class::tris,
+            &Class::numVAdjs,
+            &Class::vAdjs,
+            &Class::numVertAttr,
+            &Class::vertAttr,
+            &Class::numVertsq,
+            &Class::vertsq,
+            &Class::numVertsqOffset,
+            &Class::vertsqOffset,
+            &Class::numNodecps,
+            &Class::nodecps,
+            &Class::numVertcps,
+            &Class::vertcps,
+            &Class::vertRecycleArraySize,
+            &Class::vertRecycleCursor,
+            &Class::vertRecycle);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::DysonSphereLayer>
+{
+    typedef DysonSphereParser::DysonSphereLayer Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::id,
+            &Class::orbitRadius,
+            &Class::orbitRotation,
+            &Class::orbitAngularSpeed,
+            &Class::currentAngle,
+            &Class::currentRotation,
+            &Class::nextRotation,
+            &Class::gridMode,
+            &Class::nodeCapacity,
+            &Class::nodeCursor,
+            &Class::nodeRecycleCursor,
+            &Class::dysonNodeIndex,
+            &Class::nodePool,
+            &Class::nodeRecycle,
+            &Class::frameCapacity,
+            &Class::frameCursor,
+            &Class::frameRecycleCursor,
+            &Class::dysonFrameIndex,
+            &Class::framePool,
+            &Class::frameRecycle,
+            &Class::shellCapacity,
+            &Class::shellCursor,
+            &Class::shellRecycleCursor,
+            &Class::dysonShellIndex,
+            &Class::shellPool,
+            &Class::shellRecycle);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::DysonSphere>
+{
+    typedef DysonSphereParser::DysonSphere Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::randSeed,
+            &Class::swarm,
+            &Class::twelveTwelve,
+            &Class::layerCount,
+            &Class::numDysonSphereLayer,
+            &Class::dysonSphereLayerIndex,
+            &Class::dysonSphereLayer,
+            &Class::rocketCapacity,
+            &Class::rocketCursor,
+            &Class::rocketRecycleCursor,
+            &Class::rocketPool,
+            &Class::rocketRecycle,
+            &Class::autoNodeCount,
+            &Class::numAutoNodes,
+            &Class::autoNodeIncludedFlag,
+            &Class::layerId,
+            &Class::nodeId,
+            &Class::nrdCapacity,
+            &Class::nrdCursor,
+            &Class::nrdRecycleCursor,
+            &Class::nrdPool,
+            &Class::nrdRecycle);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::GameData>
+{
+    typedef DysonSphereParser::GameData Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::version,
+            &Class::gameName,
+            &Class::gameDesc,
+            &Class::gameTick,
+            &Class::preferences,
+            &Class::history,
+            &Class::hidePlayerModel,
+            &Class::disableController,
+            &Class::statistics,
+            &Class::planetId,
+            &Class::mainPlayer,
+            &Class::factoryCount,
+            &Class::galacticTransport,
+            &Class::factories,
+            &Class::galaxyStarCount,
+            &Class::dysonSphereIndex,
+            &Class::dysonSphereSlot,
+            &Class::dysonSpheres);
+    }
+};
+
+template<>
+struct DysonSphereSnapshot<DysonSphereParser::GameSave>
+{
+    typedef DysonSphereParser::GameSave Class;
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(
+            &Class::fileStreamLength,
+            &Class::saveFileFormatNumber,
+            &Class::majorGameVersion,
+            &Class::minorGameVersion,
+            &Class::releaseGameVersion,
+            &Class::gameTick,
+            &Class::nowTicks,
+            &Class::sizeOfPngFile,
+            &Class::screenShotPngFile,
+            &Class::data);
+    }
+};